@@ -0,0 +1,157 @@
+#include "animation_export.hpp"
+
+#include "y4m_writer.hpp"
+
+#include <renderer/image.hpp>
+
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+// Numbers frames as in frames/orbit_00012.png for the output
+//  frames/orbit.png.
+fs::path frame_path (fs::path const& output, size_t frame)
+{
+	std::stringstream name;
+	name << output.stem().string() << "_" << std::setw (5)
+		 << std::setfill ('0') << frame << output.extension().string();
+	return output.parent_path() / name.str();
+}
+
+// The time uniform animates shaders on its own unless the path sets it.
+std::unique_ptr<renderer::Uniform> time_uniform (
+	std::vector<std::unique_ptr<renderer::Uniform>> const& declarations,
+	std::vector<Uniform_Assignment> const&                 assignments,
+	double                                                 time)
+{
+	const std::string name = "f_globals.time";
+	for (Uniform_Assignment const& assignment : assignments)
+	{
+		if (assignment.name == name)
+		{
+			return nullptr;
+		}
+	}
+
+	for (std::unique_ptr<renderer::Uniform> const& declaration : declarations)
+	{
+		if (declaration->get_name() == name)
+		{
+			return create_uniform (*declaration, {time});
+		}
+	}
+	return nullptr;
+}
+
+} // namespace
+
+bool export_animation (
+	renderer::Renderer&                                    renderer,
+	std::vector<std::unique_ptr<renderer::Uniform>> const& declarations,
+	Animation_Path const&                                  path,
+	Export_Settings const&                                 settings)
+{
+	std::ofstream               file;
+	std::unique_ptr<Y4m_Writer> video;
+	if (settings.output == "-")
+	{
+		video = std::make_unique<Y4m_Writer> (
+			std::cout,
+			settings.width,
+			settings.height,
+			settings.frames_per_second);
+	}
+	else if (settings.output.extension() == ".y4m")
+	{
+		file.open (settings.output, std::ios::binary);
+		video = std::make_unique<Y4m_Writer> (
+			file,
+			settings.width,
+			settings.height,
+			settings.frames_per_second);
+	}
+
+	if (video != nullptr && !video->is_valid())
+	{
+		std::cerr << "Could not write to " << settings.output.string() << "\n";
+		return false;
+	}
+
+	// Both ends of the path are rendered.
+	const size_t frame_count
+		= static_cast<size_t> (
+			  std::llround (path.get_duration() * settings.frames_per_second))
+		  + 1;
+
+	// Written from the worker thread which encodes the frames.
+	std::atomic<bool> failed{false};
+
+	renderer.set_frames_in_flight (settings.frames_in_flight);
+	for (size_t frame = 0; frame < frame_count && !failed; ++frame)
+	{
+		const double time
+			= static_cast<double> (frame) / settings.frames_per_second;
+
+		const std::vector<Uniform_Assignment> assignments = path.sample (time);
+		std::vector<std::string>              errors;
+		std::vector<std::unique_ptr<renderer::Uniform>> uniforms
+			= apply_assignments (declarations, assignments, errors);
+		if (!errors.empty())
+		{
+			for (std::string const& error : errors)
+			{
+				std::cerr << error << "\n";
+			}
+			failed = true;
+			break;
+		}
+
+		if (auto uniform = time_uniform (declarations, assignments, time))
+		{
+			uniforms.push_back (std::move (uniform));
+		}
+		for (std::unique_ptr<renderer::Uniform> const& uniform : uniforms)
+		{
+			renderer.set_uniform (*uniform);
+		}
+
+		renderer.render_capture (
+			settings.width,
+			settings.height,
+			[&video, &failed, output = settings.output, frame] (
+				renderer::Image image) {
+				if (video != nullptr)
+				{
+					video->write_frame (image);
+					if (!video->is_valid())
+					{
+						failed = true;
+					}
+					return;
+				}
+
+				const fs::path image_path = frame_path (output, frame);
+				if (!renderer::write_image (image_path, image))
+				{
+					std::cerr << "Failed to write " << image_path.string()
+							  << "\n";
+					failed = true;
+				}
+			});
+
+		std::cerr << "\rRendered " << frame + 1 << " of " << frame_count
+				  << " frames" << std::flush;
+	}
+	std::cerr << "\n";
+
+	renderer.poll_captures (true);
+	return !failed;
+}
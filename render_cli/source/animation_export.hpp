@@ -0,0 +1,30 @@
+#pragma once
+
+#include "animation_path.hpp"
+
+#include <renderer/renderer.hpp>
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+struct Export_Settings
+{
+	// "-" streams Y4M to stdout, a .y4m file is written as one video and any
+	//  other path is numbered into a sequence of images.
+	std::filesystem::path output;
+
+	unsigned int width             = 1280;
+	unsigned int height            = 720;
+	unsigned int frames_per_second = 30;
+	unsigned int frames_in_flight  = 3;
+};
+
+// Renders every frame of the path offscreen. Frames are read back and
+//  encoded on a worker while the following ones render, up to the number of
+//  frames in flight.
+bool export_animation (
+	renderer::Renderer&                                    renderer,
+	std::vector<std::unique_ptr<renderer::Uniform>> const& declarations,
+	Animation_Path const&                                  path,
+	Export_Settings const&                                 settings);
@@ -0,0 +1,183 @@
+#include "animation_path.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+namespace
+{
+
+double catmull_rom (double p0, double p1, double p2, double p3, double t)
+{
+	const double t2 = t * t;
+	const double t3 = t2 * t;
+	return 0.5
+		   * ((2.0 * p1) + (-p0 + p2) * t
+			  + (2.0 * p0 - 5.0 * p1 + 4.0 * p2 - p3) * t2
+			  + (-p0 + 3.0 * p1 - 3.0 * p2 + p3) * t3);
+}
+
+} // namespace
+
+Animation_Path Animation_Path::load (std::filesystem::path const& path)
+{
+	Animation_Path animation;
+
+	auto fail = [&animation] (std::string const& error) {
+		animation.valid = false;
+		animation.error = error;
+		return animation;
+	};
+
+	std::ifstream file (path);
+	if (!file.is_open())
+	{
+		return fail ("Could not open animation path: " + path.string());
+	}
+
+	std::vector<Keyframe> keyframes;
+	std::string           line;
+	while (std::getline (file, line))
+	{
+		line = trim (line);
+		if (line.empty() || line[0] == '#')
+		{
+			continue;
+		}
+
+		if (line.compare (0, 3, "at ") == 0)
+		{
+			Keyframe keyframe;
+			try
+			{
+				keyframe.time = std::stod (line.substr (3));
+			}
+			catch (std::exception const& /* e */)
+			{
+				return fail ("Invalid keyframe time in: " + line);
+			}
+			if (!keyframes.empty() && keyframe.time <= keyframes.back().time)
+			{
+				return fail ("Keyframes must be in increasing time: " + line);
+			}
+			keyframes.push_back (keyframe);
+			continue;
+		}
+
+		if (keyframes.empty())
+		{
+			return fail ("Expected \"at <seconds>\" before: " + line);
+		}
+
+		Uniform_Assignment assignment = parse_assignment (line);
+		if (!assignment.valid)
+		{
+			return fail (assignment.error);
+		}
+		keyframes.back().assignments.push_back (assignment);
+	}
+
+	if (keyframes.empty())
+	{
+		return fail ("The animation path has no keyframes: " + path.string());
+	}
+
+	for (Keyframe const& keyframe : keyframes)
+	{
+		animation.add_keyframe (keyframe);
+	}
+	for (Track const& track : animation.tracks)
+	{
+		for (Key const& key : track.keys)
+		{
+			if (key.values.size() != track.keys.front().values.size())
+			{
+				return fail ("Keyframes of " + track.name
+							 + " have different numbers of values.");
+			}
+		}
+	}
+	animation.duration = keyframes.back().time;
+	return animation;
+}
+
+bool Animation_Path::is_valid() const
+{
+	return valid;
+}
+
+std::string const& Animation_Path::get_error() const
+{
+	return error;
+}
+
+double Animation_Path::get_duration() const
+{
+	return duration;
+}
+
+std::vector<Uniform_Assignment> Animation_Path::sample (double time) const
+{
+	std::vector<Uniform_Assignment> assignments;
+	for (Track const& track : tracks)
+	{
+		Uniform_Assignment assignment;
+		assignment.name = track.name;
+
+		std::vector<Key> const& keys = track.keys;
+
+		const auto next = std::upper_bound (
+			keys.begin(),
+			keys.end(),
+			time,
+			[] (double value, Key const& key) { return value < key.time; });
+
+		if (next == keys.begin())
+		{
+			assignment.values = keys.front().values;
+		}
+		else if (next == keys.end())
+		{
+			assignment.values = keys.back().values;
+		}
+		else
+		{
+			// The neighbouring keys are repeated at either end of the track.
+			const size_t i2 = static_cast<size_t> (next - keys.begin());
+			const size_t i1 = i2 - 1;
+			const size_t i0 = i1 == 0 ? i1 : i1 - 1;
+			const size_t i3 = i2 + 1 == keys.size() ? i2 : i2 + 1;
+
+			const double t
+				= (time - keys[i1].time) / (keys[i2].time - keys[i1].time);
+			for (size_t v = 0; v < keys[i1].values.size(); ++v)
+			{
+				assignment.values.push_back (catmull_rom (
+					keys[i0].values[v],
+					keys[i1].values[v],
+					keys[i2].values[v],
+					keys[i3].values[v],
+					t));
+			}
+		}
+		assignments.push_back (assignment);
+	}
+	return assignments;
+}
+
+void Animation_Path::add_keyframe (Keyframe const& keyframe)
+{
+	for (Uniform_Assignment const& assignment : keyframe.assignments)
+	{
+		auto track = std::find_if (
+			tracks.begin(),
+			tracks.end(),
+			[&assignment] (Track const& track) {
+				return track.name == assignment.name;
+			});
+		if (track == tracks.end())
+		{
+			track = tracks.insert (tracks.end(), Track{assignment.name, {}});
+		}
+		track->keys.push_back (Key{keyframe.time, assignment.values});
+	}
+}
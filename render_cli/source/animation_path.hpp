@@ -0,0 +1,60 @@
+#pragma once
+
+#include "uniform_overrides.hpp"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Uniform values at one point in time, a keyframe only needs to list the
+//  uniforms which it moves.
+struct Keyframe
+{
+	double                          time = 0.0;
+	std::vector<Uniform_Assignment> assignments;
+};
+
+// A path through the uniforms of a shader, usually those of Camera_2d or
+//  Camera_3d. The file lists keyframes as "at <seconds>" followed by one
+//  name = values line per uniform:
+//
+//      at 0
+//      camera.position = 0, 0, -3
+//      at 4
+//      camera.position = 3, 0, 0
+//      camera.yaw = -1.57
+//
+//  Each uniform is interpolated with a Catmull-Rom spline through the
+//  keyframes which set it and holds its first and last values outside them.
+class Animation_Path
+{
+public:
+	static Animation_Path load (std::filesystem::path const& path);
+
+	bool               is_valid() const;
+	std::string const& get_error() const;
+
+	double get_duration() const;
+
+	std::vector<Uniform_Assignment> sample (double time) const;
+
+private:
+	struct Key
+	{
+		double              time;
+		std::vector<double> values;
+	};
+
+	struct Track
+	{
+		std::string      name;
+		std::vector<Key> keys;
+	};
+
+	bool               valid = true;
+	std::string        error;
+	std::vector<Track> tracks;
+	double             duration = 0.0;
+
+	void add_keyframe (Keyframe const& keyframe);
+};
@@ -0,0 +1,318 @@
+#include "benchmark.hpp"
+
+#include <renderer/image.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+bool parse_size (
+	std::string const& text,
+	unsigned int&      width,
+	unsigned int&      height)
+{
+	char              separator = 0;
+	std::stringstream stream (text);
+	return (stream >> width >> separator >> height) && separator == 'x'
+		   && width > 0 && height > 0 && stream.eof();
+}
+
+// Only binary PPMs as written by write_image are read.
+bool read_ppm (fs::path const& path, renderer::Image& image)
+{
+	std::ifstream file (path, std::ios::binary);
+	std::string   magic;
+	unsigned int  max_value = 0;
+	if (!(file >> magic >> image.width >> image.height >> max_value)
+		|| magic != "P6" || max_value != 255)
+	{
+		return false;
+	}
+	file.get();
+
+	image.pixels.resize (size_t{image.width} * image.height * 3);
+	file.read (
+		reinterpret_cast<char*> (image.pixels.data()),
+		static_cast<std::streamsize> (image.pixels.size()));
+	return static_cast<bool> (file);
+}
+
+// Percentage of pixels with a channel further apart than the threshold.
+double differing_pixels (
+	renderer::Image const& image,
+	renderer::Image const& golden,
+	unsigned int           threshold)
+{
+	if (image.width != golden.width || image.height != golden.height)
+	{
+		return 100.0;
+	}
+
+	size_t differing = 0;
+	for (size_t pixel = 0; pixel < image.pixels.size(); pixel += 3)
+	{
+		for (size_t channel = pixel; channel < pixel + 3; ++channel)
+		{
+			const int difference = static_cast<int> (image.pixels[channel])
+								   - static_cast<int> (golden.pixels[channel]);
+			if (static_cast<unsigned int> (std::abs (difference)) > threshold)
+			{
+				++differing;
+				break;
+			}
+		}
+	}
+	return 100.0 * static_cast<double> (differing)
+		   / static_cast<double> (size_t{image.width} * image.height);
+}
+
+fs::path golden_path (fs::path const& golden, Benchmark_Case const& test)
+{
+	return golden
+		   / (test.shader + "_" + test.view + "_" + std::to_string (test.width)
+			  + "x" + std::to_string (test.height) + ".ppm");
+}
+
+// Uploads the declared defaults and the overrides of the case, returns false
+//  if the shader failed to load or an override did not apply.
+bool load_case (
+	renderer::Renderer&       renderer,
+	fs::path const&           glsl,
+	fs::path const&           shader,
+	Benchmark_Case const&     test,
+	std::vector<std::string>& errors)
+{
+	std::vector<std::unique_ptr<renderer::Uniform>> declarations
+		= renderer.set_shader (glsl, shader);
+	if (declarations.empty())
+	{
+		errors.push_back ("Failed to load " + shader.string());
+		return false;
+	}
+
+	std::vector<std::unique_ptr<renderer::Uniform>> overrides
+		= apply_assignments (declarations, test.assignments, errors);
+	if (overrides.size() != test.assignments.size())
+	{
+		return false;
+	}
+
+	for (std::unique_ptr<renderer::Uniform> const& uniform : declarations)
+	{
+		renderer.set_uniform (*uniform);
+	}
+	for (std::unique_ptr<renderer::Uniform> const& uniform : overrides)
+	{
+		renderer.set_uniform (*uniform);
+	}
+	return true;
+}
+
+} // namespace
+
+std::vector<Benchmark_Case> load_benchmark (
+	fs::path const&              path,
+	std::vector<fs::path> const& shaders,
+	std::vector<std::string>&    errors)
+{
+	std::ifstream file (path);
+	if (!file.is_open())
+	{
+		errors.push_back ("Could not open benchmark file: " + path.string());
+		return {};
+	}
+
+	std::vector<std::pair<unsigned int, unsigned int>> sizes;
+	std::vector<Benchmark_Case>                        views;
+
+	std::string line;
+	size_t      line_number = 0;
+	while (std::getline (file, line))
+	{
+		++line_number;
+		line = trim (line);
+		if (line.empty() || line[0] == '#')
+		{
+			continue;
+		}
+
+		const std::string location
+			= path.string() + ":" + std::to_string (line_number) + ": ";
+
+		std::stringstream stream (line);
+		std::string       keyword;
+		stream >> keyword;
+		if (keyword == "size")
+		{
+			std::string  size;
+			unsigned int width  = 0;
+			unsigned int height = 0;
+			if (!(stream >> size) || !parse_size (size, width, height))
+			{
+				errors.push_back (location + "Expected size <width>x<height>");
+				continue;
+			}
+			sizes.emplace_back (width, height);
+		}
+		else if (keyword == "view")
+		{
+			Benchmark_Case view;
+			if (!(stream >> view.shader >> view.view))
+			{
+				errors.push_back (
+					location + "Expected view <shader> <name> [name=values]");
+				continue;
+			}
+
+			std::string assignment;
+			while (stream >> assignment)
+			{
+				view.assignments.push_back (parse_assignment (assignment));
+			}
+			views.push_back (view);
+		}
+		else
+		{
+			errors.push_back (location + "Unknown keyword " + keyword);
+		}
+	}
+
+	std::vector<Benchmark_Case> cases;
+	for (fs::path const& shader : shaders)
+	{
+		Benchmark_Case default_view;
+		default_view.shader = shader.stem().string();
+
+		std::vector<Benchmark_Case> shader_views{default_view};
+		for (Benchmark_Case const& view : views)
+		{
+			if (view.shader == default_view.shader)
+			{
+				shader_views.push_back (view);
+			}
+		}
+
+		for (Benchmark_Case& view : shader_views)
+		{
+			for (auto const& [width, height] : sizes)
+			{
+				view.width  = width;
+				view.height = height;
+				cases.push_back (view);
+			}
+		}
+	}
+	return cases;
+}
+
+bool run_benchmark (
+	renderer::Renderer&                renderer,
+	std::vector<fs::path> const&       shaders,
+	std::vector<Benchmark_Case> const& cases,
+	Benchmark_Settings const&          settings)
+{
+	std::ofstream csv (settings.csv);
+	if (!csv.is_open())
+	{
+		std::cerr << "Could not write " << settings.csv.string() << "\n";
+		return false;
+	}
+	csv << "shader,view,width,height,frames,mean_ms,min_ms,max_ms,"
+		   "mean_steps,differing_pixels_percent,result\n";
+
+	if (settings.update_golden)
+	{
+		fs::create_directories (settings.golden);
+	}
+
+	bool passed = true;
+	for (Benchmark_Case const& test : cases)
+	{
+		auto shader = std::find_if (
+			shaders.begin(),
+			shaders.end(),
+			[&test] (fs::path const& path) {
+				return path.stem().string() == test.shader;
+			});
+
+		std::vector<std::string> errors;
+		if (shader == shaders.end()
+			|| !load_case (renderer, settings.glsl, *shader, test, errors))
+		{
+			for (std::string const& error : errors)
+			{
+				std::cerr << error << "\n";
+			}
+			csv << test.shader << "," << test.view << "," << test.width << ","
+				<< test.height << ",0,,,,,,error\n";
+			passed = false;
+			continue;
+		}
+
+		const renderer::Image image
+			= renderer.render_image (test.width, test.height);
+
+		double total   = 0.0;
+		double minimum = 0.0;
+		double maximum = 0.0;
+		for (unsigned int frame = 0; frame < settings.frames; ++frame)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			renderer.render_image (test.width, test.height);
+			const double milliseconds
+				= std::chrono::duration<double, std::milli> (
+					  std::chrono::steady_clock::now() - start)
+					  .count();
+
+			total += milliseconds;
+			minimum = frame == 0 ? milliseconds
+								 : std::min (minimum, milliseconds);
+			maximum = std::max (maximum, milliseconds);
+		}
+
+		// Counting steps needs the cost attachment, which would slow down
+		//  the timed frames.
+		renderer.set_cost_overlay (true);
+		renderer.render_image (test.width, test.height);
+		const double steps = renderer.get_mean_cost();
+		renderer.set_cost_overlay (false);
+
+		const fs::path  golden = golden_path (settings.golden, test);
+		renderer::Image expected;
+		double          differing = 0.0;
+		std::string     result;
+		if (settings.update_golden)
+		{
+			const bool written = renderer::write_image (golden, image);
+			result             = written ? "updated" : "error";
+		}
+		else if (!read_ppm (golden, expected))
+		{
+			result = "missing";
+		}
+		else
+		{
+			differing = differing_pixels (image, expected, settings.threshold);
+			result    = differing <= settings.tolerance ? "pass" : "fail";
+		}
+		passed = passed && (result == "pass" || result == "updated");
+
+		const double mean = total / std::max (settings.frames, 1u);
+		csv << test.shader << "," << test.view << "," << test.width << ","
+			<< test.height << "," << settings.frames << "," << mean << ","
+			<< minimum << "," << maximum << "," << steps << "," << differing
+			<< "," << result << "\n";
+		std::cerr << test.shader << " " << test.view << " " << test.width
+				  << "x" << test.height << ": " << mean << " ms, " << steps
+				  << " steps, " << result << "\n";
+	}
+	return passed;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "uniform_overrides.hpp"
+
+#include <renderer/renderer.hpp>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+struct Benchmark_Case
+{
+	std::string                     shader;
+	std::string                     view = "default";
+	unsigned int                    width  = 0;
+	unsigned int                    height = 0;
+	std::vector<Uniform_Assignment> assignments;
+};
+
+// Reads a benchmark file, every shader is rendered at each size with its
+//  default uniforms and from each view listed for it:
+//  size 320x180
+//  view mandelbrot seahorse camera.position=-0.745,0.105 camera.zoom=0.99
+//  Errors are added to errors and the lines skipped.
+std::vector<Benchmark_Case> load_benchmark (
+	std::filesystem::path const&              path,
+	std::vector<std::filesystem::path> const& shaders,
+	std::vector<std::string>&                 errors);
+
+struct Benchmark_Settings
+{
+	std::filesystem::path glsl;
+	std::filesystem::path golden;
+	std::filesystem::path csv;
+
+	// Timed frames after one untimed frame which is compared to the golden.
+	unsigned int frames = 10;
+
+	// A pixel differs once a channel is off by more than the threshold, a
+	//  case fails when more than the tolerance in percent of pixels differ.
+	unsigned int threshold = 8;
+	double       tolerance = 0.5;
+
+	// Writes the output as the golden image instead of comparing to it.
+	bool update_golden = false;
+};
+
+// Renders every case, compares it to the golden image of the same name and
+//  writes the time per frame and the mean ray march steps or fractal
+//  iterations per pixel of each case to a CSV. Returns false if any
+//  case failed or had no golden image.
+bool run_benchmark (
+	renderer::Renderer&                       renderer,
+	std::vector<std::filesystem::path> const& shaders,
+	std::vector<Benchmark_Case> const&        cases,
+	Benchmark_Settings const&                 settings);
@@ -0,0 +1,155 @@
+#include "egl_context.hpp"
+
+#include <EGL/eglext.h>
+
+#include <cstring>
+
+namespace
+{
+
+bool has_extension (EGLDisplay display, char const* extension)
+{
+	char const* extensions = eglQueryString (display, EGL_EXTENSIONS);
+	return extensions != nullptr && std::strstr (extensions, extension);
+}
+
+} // namespace
+
+Egl_Context::Egl_Context()
+{
+	display = get_display();
+	if (display == EGL_NO_DISPLAY)
+	{
+		error = "No EGL display is available.";
+		return;
+	}
+
+	EGLint major = 0, minor = 0;
+	if (!eglInitialize (display, &major, &minor))
+	{
+		error   = "Failed to initialise EGL.";
+		display = EGL_NO_DISPLAY;
+		return;
+	}
+
+	if (!eglBindAPI (EGL_OPENGL_API))
+	{
+		error = "EGL does not support the OpenGL API.";
+		return;
+	}
+
+	// Nothing is drawn to a surface, but window configs are the default and
+	//  surfaceless displays only offer pbuffer ones.
+	const EGLint config_attributes[] = {
+		EGL_SURFACE_TYPE,
+		EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE,
+		EGL_OPENGL_BIT,
+		EGL_NONE};
+
+	EGLConfig config       = nullptr;
+	EGLint    config_count = 0;
+	eglChooseConfig (display, config_attributes, &config, 1, &config_count);
+	if (config_count == 0)
+	{
+		if (!has_extension (display, "EGL_KHR_no_config_context"))
+		{
+			error = "No EGL config supports OpenGL.";
+			return;
+		}
+		config = EGL_NO_CONFIG_KHR;
+	}
+
+	context = create_context (config);
+	if (context == EGL_NO_CONTEXT)
+	{
+		error = "Failed to create an OpenGL context.";
+		return;
+	}
+
+	if (!eglMakeCurrent (display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+	{
+		error = "The OpenGL context can not be used without a surface.";
+		eglDestroyContext (display, context);
+		context = EGL_NO_CONTEXT;
+	}
+}
+
+Egl_Context::~Egl_Context()
+{
+	if (display == EGL_NO_DISPLAY)
+	{
+		return;
+	}
+
+	eglMakeCurrent (display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	if (context != EGL_NO_CONTEXT)
+	{
+		eglDestroyContext (display, context);
+	}
+	eglTerminate (display);
+}
+
+bool Egl_Context::is_valid() const
+{
+	return context != EGL_NO_CONTEXT;
+}
+
+std::string Egl_Context::get_error() const
+{
+	return error;
+}
+
+EGLDisplay Egl_Context::get_display() const
+{
+	// Prefer the surfaceless platform since it needs neither a display server
+	//  nor a GPU device.
+	if (has_extension (EGL_NO_DISPLAY, "EGL_MESA_platform_surfaceless"))
+	{
+		auto get_platform_display
+			= reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC> (
+				eglGetProcAddress ("eglGetPlatformDisplayEXT"));
+		if (get_platform_display != nullptr)
+		{
+			EGLDisplay surfaceless = get_platform_display (
+				EGL_PLATFORM_SURFACELESS_MESA,
+				EGL_DEFAULT_DISPLAY,
+				nullptr);
+			if (surfaceless != EGL_NO_DISPLAY)
+			{
+				return surfaceless;
+			}
+		}
+	}
+
+	return eglGetDisplay (EGL_DEFAULT_DISPLAY);
+}
+
+EGLContext Egl_Context::create_context (EGLConfig config) const
+{
+	// The shaders are written in GLSL ES 3.00, which core profiles accept
+	//  from OpenGL 4.3 onwards.
+	const EGLint versions[][2] = {{4, 5}, {4, 3}, {3, 3}};
+	for (auto const& [major, minor] : versions)
+	{
+		const EGLint context_attributes[] = {
+			EGL_CONTEXT_MAJOR_VERSION,
+			major,
+			EGL_CONTEXT_MINOR_VERSION,
+			minor,
+			EGL_CONTEXT_OPENGL_PROFILE_MASK,
+			EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+			EGL_NONE};
+
+		EGLContext created = eglCreateContext (
+			display,
+			config,
+			EGL_NO_CONTEXT,
+			context_attributes);
+		if (created != EGL_NO_CONTEXT)
+		{
+			return created;
+		}
+	}
+	return EGL_NO_CONTEXT;
+}
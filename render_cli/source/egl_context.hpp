@@ -0,0 +1,29 @@
+#pragma once
+
+#include <EGL/egl.h>
+
+#include <string>
+
+// An OpenGL context without any surface, so rendering only ever targets
+//  framebuffer objects. This works without a display server and on software
+//  rasterisers such as Mesa llvmpipe.
+class Egl_Context
+{
+public:
+	Egl_Context();
+	~Egl_Context();
+
+	Egl_Context (Egl_Context const&) = delete;
+	Egl_Context& operator= (Egl_Context const&) = delete;
+
+	bool        is_valid() const;
+	std::string get_error() const;
+
+private:
+	EGLDisplay  display = EGL_NO_DISPLAY;
+	EGLContext  context = EGL_NO_CONTEXT;
+	std::string error;
+
+	EGLDisplay get_display() const;
+	EGLContext create_context (EGLConfig config) const;
+};
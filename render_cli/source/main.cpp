@@ -0,0 +1,268 @@
+#include "animation_export.hpp"
+#include "benchmark.hpp"
+#include "egl_context.hpp"
+#include "options.hpp"
+#include "uniform_overrides.hpp"
+
+#include <renderer/image.hpp>
+#include <renderer/renderer.hpp>
+#include <renderer/trace.hpp>
+
+#include <algorithm>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+std::vector<fs::path> find_shaders (
+	renderer::Renderer& renderer,
+	fs::path const&     glsl)
+{
+	const std::vector<fs::path> search_paths
+		= {glsl / "2d" / "signed_distance_functions",
+		   glsl / "3d" / "signed_distance_functions"};
+	return renderer.get_shaders (glsl, search_paths);
+}
+
+// Describes everything which affects the image, so that a checkpoint is only
+//  resumed by the same render.
+std::string describe_job (Options const& options)
+{
+	std::string job = options.shader;
+	for (Uniform_Assignment const& assignment : options.assignments)
+	{
+		job += " " + assignment.name + "=";
+		for (double const value : assignment.values)
+		{
+			job += std::to_string (value) + ",";
+		}
+	}
+	return job;
+}
+
+bool render_tiled (renderer::Renderer& renderer, Options const& options)
+{
+	return renderer.render_tiled (
+		options.output,
+		options.width,
+		options.height,
+		options.tile_size,
+		describe_job (options),
+		[] (unsigned int finished, unsigned int total) {
+			std::cerr << "\rRendered " << finished << " of " << total
+					  << " rows of tiles" << (finished == total ? "\n" : "")
+					  << std::flush;
+		});
+}
+
+void print_cost_histogram (renderer::Renderer& renderer, unsigned int bins)
+{
+	const std::vector<unsigned int> histogram
+		= renderer.get_cost_histogram (bins);
+	for (unsigned int bin = 0; bin < bins; ++bin)
+	{
+		std::cerr << bin * 100 / bins << "-" << (bin + 1) * 100 / bins
+				  << "% of budget: " << histogram[bin] << " pixels\n";
+	}
+}
+
+bool render (
+	renderer::Renderer&                                    renderer,
+	std::vector<std::unique_ptr<renderer::Uniform>> const& declarations,
+	Options const&                                         options)
+{
+	if (!options.animation.empty())
+	{
+		const Animation_Path path = Animation_Path::load (options.animation);
+		if (!path.is_valid())
+		{
+			std::cerr << path.get_error() << "\n";
+			return false;
+		}
+
+		Export_Settings settings;
+		settings.output            = options.output;
+		settings.width             = options.width;
+		settings.height            = options.height;
+		settings.frames_per_second = options.frames_per_second;
+		settings.frames_in_flight  = options.frames_in_flight;
+		return export_animation (renderer, declarations, path, settings);
+	}
+
+	// Tiled renders draw each tile on its own, so they skip the overlay.
+	if (options.tile_size != 0)
+	{
+		return render_tiled (renderer, options);
+	}
+
+	const renderer::Image image
+		= renderer.render_image (options.width, options.height);
+	if (!renderer::write_image (options.output, image))
+	{
+		std::cerr << "Failed to write " << options.output.string() << "\n";
+		return false;
+	}
+
+	if (options.cost_histogram_bins != 0)
+	{
+		print_cost_histogram (renderer, options.cost_histogram_bins);
+	}
+	return true;
+}
+
+bool benchmark (
+	renderer::Renderer&          renderer,
+	std::vector<fs::path> const& shaders,
+	Options const&               options)
+{
+	std::vector<std::string>          errors;
+	const std::vector<Benchmark_Case> cases
+		= load_benchmark (options.benchmark, shaders, errors);
+	for (std::string const& error : errors)
+	{
+		std::cerr << error << "\n";
+	}
+	if (!errors.empty())
+	{
+		return false;
+	}
+
+	Benchmark_Settings settings;
+	settings.glsl          = options.glsl;
+	settings.golden        = options.golden;
+	settings.csv           = options.benchmark_csv;
+	settings.frames        = options.benchmark_frames;
+	settings.tolerance     = options.tolerance;
+	settings.update_golden = options.update_golden;
+	return run_benchmark (renderer, shaders, cases, settings);
+}
+
+void print_statistics (renderer::Renderer& renderer)
+{
+	const unsigned long long skipped = renderer.get_skipped_steps();
+	if (skipped != 0)
+	{
+		std::cerr << "Cone prepass skipped " << skipped
+				  << " ray march steps of the last frame\n";
+	}
+
+	for (auto const& [shader, statistics] : renderer.get_gpu_statistics (true))
+	{
+		std::cerr << shader << ": compiled in " << statistics.compile
+				  << " ms, " << statistics.frames << " frames, GPU ms last "
+				  << statistics.last << " min " << statistics.min << " mean "
+				  << statistics.mean << " p99 " << statistics.p99 << "\n";
+	}
+}
+
+} // namespace
+
+int main (int argc, char** argv)
+{
+	const Options options = parse_options (argc, argv);
+	if (!options.valid || options.help)
+	{
+		if (!options.valid)
+		{
+			std::cerr << options.error << "\n\n";
+		}
+		std::cerr << usage (argv[0]);
+		return options.valid ? 0 : 1;
+	}
+
+	if (!options.trace.empty())
+	{
+		renderer::trace::start (options.trace);
+	}
+
+	Egl_Context context;
+	if (!context.is_valid())
+	{
+		std::cerr << context.get_error() << "\n";
+		return 1;
+	}
+
+	renderer::Renderer          renderer;
+	const std::vector<fs::path> shaders = find_shaders (renderer, options.glsl);
+	renderer.set_cone_prepass (options.cone_prepass);
+	renderer.set_deferred_shading (options.deferred_shading);
+
+	if (options.list_shaders)
+	{
+		for (fs::path const& shader : shaders)
+		{
+			std::cout << shader.stem().string() << "\n";
+		}
+		return 0;
+	}
+
+	if (!options.benchmark.empty())
+	{
+		return benchmark (renderer, shaders, options) ? 0 : 1;
+	}
+
+	auto shader = std::find_if (
+		shaders.begin(),
+		shaders.end(),
+		[&options] (fs::path const& path) {
+			return path.stem().string() == options.shader;
+		});
+	if (shader == shaders.end())
+	{
+		std::cerr << "No shader named " << options.shader << " was found in "
+				  << options.glsl.string() << "\n";
+		return 1;
+	}
+
+	std::vector<std::unique_ptr<renderer::Uniform>> declarations
+		= renderer.set_shader (options.glsl, *shader);
+	if (declarations.empty())
+	{
+		std::cerr << "Failed to load " << shader->string() << "\n";
+		return 1;
+	}
+
+	std::vector<std::string> errors;
+	std::vector<std::unique_ptr<renderer::Uniform>> overrides
+		= apply_assignments (declarations, options.assignments, errors);
+	for (std::string const& error : errors)
+	{
+		std::cerr << error << "\n";
+	}
+	if (!errors.empty())
+	{
+		return 1;
+	}
+
+	// Program uniforms start out as zero, upload the declared defaults first.
+	for (std::unique_ptr<renderer::Uniform> const& uniform : declarations)
+	{
+		renderer.set_uniform (*uniform);
+	}
+	for (std::unique_ptr<renderer::Uniform> const& uniform : overrides)
+	{
+		renderer.set_uniform (*uniform);
+	}
+
+	if (!options.deep_zoom_real.empty()
+		&& !renderer.set_deep_zoom (
+			options.deep_zoom_real,
+			options.deep_zoom_imaginary,
+			options.deep_zoom_width))
+	{
+		std::cerr << options.shader << " can not deep zoom to "
+				  << options.deep_zoom_real << ", "
+				  << options.deep_zoom_imaginary << "\n";
+		return 1;
+	}
+
+	renderer.set_cost_overlay (options.cost_overlay);
+	const bool rendered = render (renderer, declarations, options);
+	if (options.statistics)
+	{
+		print_statistics (renderer);
+	}
+	return rendered ? 0 : 1;
+}
@@ -0,0 +1,344 @@
+#include "options.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+// The build copies the shaders next to the bin directory, as for the viewer.
+fs::path default_glsl_path (char const* program)
+{
+	fs::path build;
+	for (fs::path const& subpath : fs::absolute (program).parent_path())
+	{
+		std::string folder = subpath.string();
+		std::transform (
+			folder.begin(),
+			folder.end(),
+			folder.begin(),
+			::tolower);
+		if (folder == "bin")
+		{
+			break;
+		}
+		build /= subpath;
+	}
+	return build / "glsl";
+}
+
+bool parse_unsigned (std::string const& text, unsigned int& value)
+{
+	try
+	{
+		const unsigned long parsed = std::stoul (text);
+		value                      = static_cast<unsigned int> (parsed);
+		return parsed > 0;
+	}
+	catch (std::exception const& /* e */)
+	{
+		return false;
+	}
+}
+
+bool parse_double (std::string const& text, double& value)
+{
+	try
+	{
+		value = std::stod (text);
+		return value >= 0.0;
+	}
+	catch (std::exception const& /* e */)
+	{
+		return false;
+	}
+}
+
+// Splits <real>,<imaginary>,<width>, the coordinates stay decimal strings
+//  since a double would round them.
+bool parse_deep_zoom (std::string const& text, Options& options)
+{
+	const size_t first  = text.find (',');
+	const size_t second = text.find (',', first + 1);
+	if (first == std::string::npos || second == std::string::npos)
+	{
+		return false;
+	}
+
+	options.deep_zoom_real      = text.substr (0, first);
+	options.deep_zoom_imaginary = text.substr (first + 1, second - first - 1);
+	return parse_double (text.substr (second + 1), options.deep_zoom_width)
+		   && options.deep_zoom_width > 0.0;
+}
+
+} // namespace
+
+Options parse_options (int argc, char** argv)
+{
+	Options options;
+	options.glsl = default_glsl_path (argv[0]);
+
+	auto fail = [&options] (std::string const& error) {
+		options.valid = false;
+		options.error = error;
+		return options;
+	};
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string argument  = argv[i];
+		const bool        has_value = i + 1 < argc;
+
+		if (argument == "-h" || argument == "--help")
+		{
+			options.help = true;
+		}
+		else if (argument == "--list")
+		{
+			options.list_shaders = true;
+		}
+		else if (argument == "--stats")
+		{
+			options.statistics = true;
+		}
+		else if (argument == "--cost-overlay")
+		{
+			options.cost_overlay = true;
+		}
+		else if (argument == "--no-cone-prepass")
+		{
+			options.cone_prepass = false;
+		}
+		else if (argument == "--no-deferred-shading")
+		{
+			options.deferred_shading = false;
+		}
+		else if (argument == "--cost-histogram")
+		{
+			if (!has_value
+				|| !parse_unsigned (argv[++i], options.cost_histogram_bins))
+			{
+				return fail ("--cost-histogram expects a positive integer.");
+			}
+			options.cost_overlay = true;
+		}
+		else if (argument == "--width" || argument == "--height")
+		{
+			unsigned int& size
+				= argument == "--width" ? options.width : options.height;
+			if (!has_value || !parse_unsigned (argv[++i], size))
+			{
+				return fail (argument + " expects a positive integer.");
+			}
+		}
+		else if (argument == "--tile-size")
+		{
+			if (!has_value || !parse_unsigned (argv[++i], options.tile_size))
+			{
+				return fail ("--tile-size expects a positive integer.");
+			}
+		}
+		else if (argument == "--deep-zoom")
+		{
+			if (!has_value || !parse_deep_zoom (argv[++i], options))
+			{
+				return fail ("--deep-zoom expects real,imaginary,width.");
+			}
+		}
+		else if (argument == "--animation")
+		{
+			if (!has_value)
+			{
+				return fail ("--animation expects a file path.");
+			}
+			options.animation = argv[++i];
+		}
+		else if (argument == "--fps" || argument == "--frames-in-flight")
+		{
+			unsigned int& value = argument == "--fps"
+									  ? options.frames_per_second
+									  : options.frames_in_flight;
+			if (!has_value || !parse_unsigned (argv[++i], value))
+			{
+				return fail (argument + " expects a positive integer.");
+			}
+		}
+		else if (argument == "--benchmark")
+		{
+			if (!has_value)
+			{
+				return fail ("--benchmark expects a file path.");
+			}
+			options.benchmark = argv[++i];
+		}
+		else if (argument == "--golden")
+		{
+			if (!has_value)
+			{
+				return fail ("--golden expects a directory.");
+			}
+			options.golden = argv[++i];
+		}
+		else if (argument == "--csv")
+		{
+			if (!has_value)
+			{
+				return fail ("--csv expects a file path.");
+			}
+			options.benchmark_csv = argv[++i];
+		}
+		else if (argument == "--frames")
+		{
+			if (!has_value
+				|| !parse_unsigned (argv[++i], options.benchmark_frames))
+			{
+				return fail ("--frames expects a positive integer.");
+			}
+		}
+		else if (argument == "--tolerance")
+		{
+			if (!has_value || !parse_double (argv[++i], options.tolerance))
+			{
+				return fail ("--tolerance expects a percentage.");
+			}
+		}
+		else if (argument == "--update-golden")
+		{
+			options.update_golden = true;
+		}
+		else if (argument == "--output" || argument == "-o")
+		{
+			if (!has_value)
+			{
+				return fail (argument + " expects a file path.");
+			}
+			options.output = argv[++i];
+		}
+		else if (argument == "--trace")
+		{
+			if (!has_value)
+			{
+				return fail ("--trace expects a file path.");
+			}
+			options.trace = argv[++i];
+		}
+		else if (argument == "--glsl")
+		{
+			if (!has_value)
+			{
+				return fail ("--glsl expects the shader directory.");
+			}
+			options.glsl = argv[++i];
+		}
+		else if (argument == "--set")
+		{
+			if (!has_value)
+			{
+				return fail ("--set expects name=values.");
+			}
+			options.assignments.push_back (parse_assignment (argv[++i]));
+		}
+		else if (argument == "--uniforms")
+		{
+			if (!has_value)
+			{
+				return fail ("--uniforms expects a file path.");
+			}
+			for (Uniform_Assignment& assignment : load_assignments (argv[++i]))
+			{
+				options.assignments.push_back (std::move (assignment));
+			}
+		}
+		else if (!argument.empty() && argument[0] == '-')
+		{
+			return fail ("Unknown option " + argument);
+		}
+		else if (options.shader.empty())
+		{
+			options.shader = argument;
+		}
+		else
+		{
+			return fail ("Only one shader can be rendered at a time.");
+		}
+	}
+
+	if (!options.benchmark.empty() && options.golden.empty())
+	{
+		options.golden = options.benchmark.parent_path() / "golden";
+	}
+
+	if (options.shader.empty() && options.benchmark.empty() && !options.help
+		&& !options.list_shaders)
+	{
+		return fail ("No shader was given.");
+	}
+	return options;
+}
+
+std::string usage (std::string const& program)
+{
+	return "Usage: " + program + " [options] <shader>\n"
+		   "       " + program + " --benchmark <file> [options]\n"
+		   "\n"
+		   "Renders a shader offscreen and writes the result to an image.\n"
+		   "\n"
+		   "Options:\n"
+		   "  --list                List the available shaders.\n"
+		   "  --width <pixels>      Width of the image, 1280 by default.\n"
+		   "  --height <pixels>     Height of the image, 720 by default.\n"
+		   "  -o, --output <file>   A .png or .ppm file, render.png by\n"
+		   "                        default.\n"
+		   "  --tile-size <pixels>  Render in tiles streamed to the output,\n"
+		   "                        for images larger than a framebuffer.\n"
+		   "                        Interrupted renders resume from a\n"
+		   "                        checkpoint next to the output.\n"
+		   "  --deep-zoom <real,imaginary,width>\n"
+		   "                        Centre a 2D fractal on coordinates of\n"
+		   "                        any precision, the view is the width\n"
+		   "                        wide, e.g. -0.75,0.1,1e-40.\n"
+		   "  --animation <file>    Export a keyframed path, see\n"
+		   "                        animation_path.hpp. The output is \"-\"\n"
+		   "                        for Y4M on stdout, a .y4m video or the\n"
+		   "                        name of a numbered image sequence.\n"
+		   "  --fps <frames>        Frames per second of an animation, 30\n"
+		   "                        by default.\n"
+		   "  --frames-in-flight <frames>\n"
+		   "                        Frames rendered ahead of the encoder, 3\n"
+		   "                        by default.\n"
+		   "  --set <name=values>   Override a uniform, e.g.\n"
+		   "                        --set camera.position=0,0,-4\n"
+		   "  --uniforms <file>     Read one name = values override per line.\n"
+		   "  --stats               Print the compile time and GPU time per\n"
+		   "                        frame of the shader, and the ray march\n"
+		   "                        steps the cone prepass skipped.\n"
+		   "  --cost-overlay        Blend a heatmap of the ray march steps or\n"
+		   "                        fractal iterations of each pixel over\n"
+		   "                        the image.\n"
+		   "  --cost-histogram <bins>\n"
+		   "                        Also print how many pixels used each\n"
+		   "                        fraction of their step budget.\n"
+		   "  --no-cone-prepass     March every ray from the camera instead\n"
+		   "                        of skipping what a low resolution\n"
+		   "                        prepass found to be empty.\n"
+		   "  --no-deferred-shading Colour each pixel while marching or\n"
+		   "                        iterating instead of from a G-buffer.\n"
+		   "  --benchmark <file>    Render every shader at the sizes and\n"
+		   "                        views of a benchmark file, compare them\n"
+		   "                        to golden images and write the time\n"
+		   "                        per frame to a CSV.\n"
+		   "  --golden <directory>  Golden images of the benchmark, golden\n"
+		   "                        next to the benchmark file by default.\n"
+		   "  --update-golden       Write the golden images instead.\n"
+		   "  --tolerance <percent> Pixels which may differ from a golden\n"
+		   "                        image, 0.5 by default.\n"
+		   "  --frames <frames>     Timed frames per case, 10 by default.\n"
+		   "  --csv <file>          Benchmark results, benchmark.csv by\n"
+		   "                        default.\n"
+		   "  --trace <file>        Write a Chrome trace of the run, as does\n"
+		   "                        setting RENDERER_TRACE to a file path.\n"
+		   "  --glsl <directory>    Where the shaders are, defaults to the\n"
+		   "                        build directory of the executable.\n";
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "uniform_overrides.hpp"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+struct Options
+{
+	bool        valid = true;
+	std::string error;
+
+	bool help             = false;
+	bool list_shaders     = false;
+	bool statistics       = false;
+	bool cost_overlay     = false;
+	bool cone_prepass     = true;
+	bool deferred_shading = true;
+
+	std::string           shader;
+	std::filesystem::path glsl;
+	std::filesystem::path output = "render.png";
+	std::filesystem::path trace;
+
+	unsigned int width  = 1280;
+	unsigned int height = 720;
+
+	// Renders in tiles of this size when set, for images too large for a
+	//  single framebuffer.
+	unsigned int tile_size = 0;
+
+	// Centres a 2D fractal on coordinates of any precision, the view is the
+	//  width wide. Empty unless deep zooming.
+	std::string deep_zoom_real;
+	std::string deep_zoom_imaginary;
+	double      deep_zoom_width = 0.0;
+
+	// Prints how many pixels used each fraction of their step budget.
+	unsigned int cost_histogram_bins = 0;
+
+	// Exports every frame of a keyframed path instead of a single image.
+	std::filesystem::path animation;
+	unsigned int          frames_per_second = 30;
+	unsigned int          frames_in_flight  = 3;
+
+	// Renders the cases of a benchmark file instead of a single shader.
+	std::filesystem::path benchmark;
+	std::filesystem::path golden;
+	std::filesystem::path benchmark_csv    = "benchmark.csv";
+	unsigned int          benchmark_frames = 10;
+	double                tolerance        = 0.5;
+	bool                  update_golden    = false;
+
+	std::vector<Uniform_Assignment> assignments;
+};
+
+Options parse_options (int argc, char** argv);
+
+std::string usage (std::string const& program);
@@ -0,0 +1,179 @@
+#include "uniform_overrides.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+
+template <typename T>
+std::unique_ptr<renderer::Uniform> create_typed_uniform (
+	renderer::Uniform const&   declaration,
+	std::vector<double> const& values)
+{
+	const auto typed
+		= dynamic_cast<renderer::Typed_Uniform<T> const*> (&declaration);
+	if (typed == nullptr || typed->get_values().size() != values.size())
+	{
+		return nullptr;
+	}
+
+	std::vector<T> converted;
+	for (double const value : values)
+	{
+		converted.push_back (static_cast<T> (value));
+	}
+	return std::make_unique<renderer::Typed_Uniform<T>> (
+		declaration.get_name(),
+		converted);
+}
+
+} // namespace
+
+std::string trim (std::string const& text)
+{
+	const size_t begin = text.find_first_not_of (" \t\r\n");
+	if (begin == std::string::npos)
+	{
+		return "";
+	}
+	const size_t end = text.find_last_not_of (" \t\r\n");
+	return text.substr (begin, end - begin + 1);
+}
+
+Uniform_Assignment parse_assignment (std::string const& text)
+{
+	Uniform_Assignment assignment;
+
+	const size_t equals = text.find ('=');
+	if (equals == std::string::npos)
+	{
+		assignment.valid = false;
+		assignment.error = "Expected name = values in: " + text;
+		return assignment;
+	}
+
+	assignment.name = trim (text.substr (0, equals));
+
+	std::string values = text.substr (equals + 1);
+	std::replace (values.begin(), values.end(), ',', ' ');
+
+	std::stringstream stream (values);
+	std::string       value;
+	while (stream >> value)
+	{
+		if (value == "true" || value == "false")
+		{
+			assignment.values.push_back (value == "true" ? 1.0 : 0.0);
+			continue;
+		}
+
+		try
+		{
+			assignment.values.push_back (std::stod (value));
+		}
+		catch (std::exception const& /* e */)
+		{
+			assignment.valid = false;
+			assignment.error = "Invalid value " + value + " for "
+							   + assignment.name;
+			return assignment;
+		}
+	}
+
+	if (assignment.name.empty() || assignment.values.empty())
+	{
+		assignment.valid = false;
+		assignment.error = "Expected name = values in: " + text;
+	}
+	return assignment;
+}
+
+std::vector<Uniform_Assignment>
+load_assignments (std::filesystem::path const& path)
+{
+	std::ifstream file (path);
+	if (!file.is_open())
+	{
+		Uniform_Assignment missing;
+		missing.valid = false;
+		missing.error = "Could not open uniform file: " + path.string();
+		return {missing};
+	}
+
+	std::vector<Uniform_Assignment> assignments;
+	std::string                     line;
+	while (std::getline (file, line))
+	{
+		line = trim (line);
+		if (line.empty() || line[0] == '#')
+		{
+			continue;
+		}
+		assignments.push_back (parse_assignment (line));
+	}
+	return assignments;
+}
+
+std::unique_ptr<renderer::Uniform> create_uniform (
+	renderer::Uniform const&   declaration,
+	std::vector<double> const& values)
+{
+	if (auto uniform = create_typed_uniform<bool> (declaration, values))
+	{
+		return uniform;
+	}
+	if (auto uniform = create_typed_uniform<int> (declaration, values))
+	{
+		return uniform;
+	}
+	if (auto uniform = create_typed_uniform<unsigned int> (declaration, values))
+	{
+		return uniform;
+	}
+	if (auto uniform = create_typed_uniform<float> (declaration, values))
+	{
+		return uniform;
+	}
+	return create_typed_uniform<double> (declaration, values);
+}
+
+std::vector<std::unique_ptr<renderer::Uniform>> apply_assignments (
+	std::vector<std::unique_ptr<renderer::Uniform>> const& declarations,
+	std::vector<Uniform_Assignment> const&                 assignments,
+	std::vector<std::string>&                              errors)
+{
+	std::vector<std::unique_ptr<renderer::Uniform>> uniforms;
+	for (Uniform_Assignment const& assignment : assignments)
+	{
+		if (!assignment.valid)
+		{
+			errors.push_back (assignment.error);
+			continue;
+		}
+
+		auto declaration = std::find_if (
+			declarations.begin(),
+			declarations.end(),
+			[&assignment] (std::unique_ptr<renderer::Uniform> const& uniform) {
+				return uniform->get_name() == assignment.name;
+			});
+		if (declaration == declarations.end())
+		{
+			errors.push_back ("The shader has no uniform " + assignment.name);
+			continue;
+		}
+
+		std::unique_ptr<renderer::Uniform> uniform
+			= create_uniform (**declaration, assignment.values);
+		if (uniform == nullptr)
+		{
+			errors.push_back (
+				"Wrong number of values for " + assignment.name);
+			continue;
+		}
+		uniforms.push_back (std::move (uniform));
+	}
+	return uniforms;
+}
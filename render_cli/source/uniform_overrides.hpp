@@ -0,0 +1,39 @@
+#pragma once
+
+#include <renderer/uniform.hpp>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct Uniform_Assignment
+{
+	bool                valid = true;
+	std::string         error;
+	std::string         name;
+	std::vector<double> values;
+};
+
+std::string trim (std::string const& text);
+
+// Parses "name = value, value", values may also be separated by spaces and
+//  booleans are written as true or false.
+Uniform_Assignment parse_assignment (std::string const& text);
+
+// Reads one assignment per line, empty lines and lines starting with # are
+//  skipped.
+std::vector<Uniform_Assignment>
+load_assignments (std::filesystem::path const& path);
+
+// Creates a uniform with the type and size of the declaration, returns null
+//  if the number of values does not match.
+std::unique_ptr<renderer::Uniform> create_uniform (
+	renderer::Uniform const&   declaration,
+	std::vector<double> const& values);
+
+// Applies each assignment to the declared uniform with the same name.
+std::vector<std::unique_ptr<renderer::Uniform>> apply_assignments (
+	std::vector<std::unique_ptr<renderer::Uniform>> const& declarations,
+	std::vector<Uniform_Assignment> const&                 assignments,
+	std::vector<std::string>&                              errors);
@@ -0,0 +1,101 @@
+#include "y4m_writer.hpp"
+
+#include <renderer/trace.hpp>
+
+#include <algorithm>
+
+namespace
+{
+
+std::uint8_t luma (int r, int g, int b)
+{
+	return static_cast<std::uint8_t> (
+		((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+}
+
+std::uint8_t blue_difference (int r, int g, int b)
+{
+	return static_cast<std::uint8_t> (
+		((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+}
+
+std::uint8_t red_difference (int r, int g, int b)
+{
+	return static_cast<std::uint8_t> (
+		((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+}
+
+} // namespace
+
+Y4m_Writer::Y4m_Writer (
+	std::ostream& stream,
+	unsigned int  width,
+	unsigned int  height,
+	unsigned int  frames_per_second)
+	: stream (stream)
+	, width (width)
+	, height (height)
+{
+	stream << "YUV4MPEG2 W" << width << " H" << height << " F"
+		   << frames_per_second << ":1 Ip A1:1 C420jpeg\n";
+}
+
+bool Y4m_Writer::is_valid() const
+{
+	return stream.good();
+}
+
+void Y4m_Writer::write_frame (renderer::Image const& image)
+{
+	TRACE_SCOPE ("Y4m_Writer::write_frame");
+	const size_t chroma_width  = (width + 1) / 2;
+	const size_t chroma_height = (height + 1) / 2;
+	const size_t luma_size     = size_t{width} * height;
+	const size_t chroma_size   = chroma_width * chroma_height;
+	planes.resize (luma_size + 2 * chroma_size);
+
+	std::uint8_t const* rgb = image.pixels.data();
+	for (size_t i = 0; i < luma_size; ++i)
+	{
+		planes[i] = luma (rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+	}
+
+	// Each chroma sample averages the 2x2 block of pixels it covers, blocks
+	//  on odd edges repeat their last row or column.
+	std::uint8_t* blue = &planes[luma_size];
+	std::uint8_t* red  = &planes[luma_size + chroma_size];
+	for (size_t y = 0; y < chroma_height; ++y)
+	{
+		const size_t rows[2]
+			= {y * 2, std::min (y * 2 + 1, size_t{height} - 1)};
+		for (size_t x = 0; x < chroma_width; ++x)
+		{
+			const size_t columns[2]
+				= {x * 2, std::min (x * 2 + 1, size_t{width} - 1)};
+
+			int sum[3] = {};
+			for (size_t row : rows)
+			{
+				for (size_t column : columns)
+				{
+					std::uint8_t const* pixel
+						= &rgb[(row * width + column) * 3];
+					sum[0] += pixel[0];
+					sum[1] += pixel[1];
+					sum[2] += pixel[2];
+				}
+			}
+
+			const int r = (sum[0] + 2) / 4;
+			const int g = (sum[1] + 2) / 4;
+			const int b = (sum[2] + 2) / 4;
+			blue[y * chroma_width + x] = blue_difference (r, g, b);
+			red[y * chroma_width + x]  = red_difference (r, g, b);
+		}
+	}
+
+	stream << "FRAME\n";
+	stream.write (
+		reinterpret_cast<char const*> (planes.data()),
+		static_cast<std::streamsize> (planes.size()));
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <renderer/image.hpp>
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Streams frames as uncompressed YUV4MPEG2, which video encoders such as
+//  ffmpeg read from a pipe. Frames are converted to 4:2:0 BT.601 video range.
+class Y4m_Writer
+{
+public:
+	Y4m_Writer (
+		std::ostream& stream,
+		unsigned int  width,
+		unsigned int  height,
+		unsigned int  frames_per_second);
+
+	bool is_valid() const;
+
+	void write_frame (renderer::Image const& image);
+
+private:
+	std::ostream&      stream;
+	const unsigned int width;
+	const unsigned int height;
+
+	std::vector<std::uint8_t> planes;
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+namespace renderer
+{
+
+// GPU time of whole frames in milliseconds, the minimum, mean and 99th
+//  percentile cover the most recent frames of a shader.
+struct Gpu_Statistics
+{
+	float        last   = 0.0f;
+	float        min    = 0.0f;
+	float        mean   = 0.0f;
+	float        p99    = 0.0f;
+	unsigned int frames = 0;
+
+	// Time spent compiling and linking the program on the CPU.
+	float compile = 0.0f;
+};
+
+} // namespace renderer
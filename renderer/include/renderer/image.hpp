@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace renderer
+{
+
+// An 8 bit RGB image stored row by row from the top of the frame.
+struct Image
+{
+	unsigned int              width  = 0;
+	unsigned int              height = 0;
+	std::vector<std::uint8_t> pixels{};
+};
+
+// Writes a binary PPM or a PNG depending on the extension of the path.
+bool write_image (std::filesystem::path const& path, Image const& image);
+
+} // namespace renderer
@@ -1,15 +1,32 @@
 #pragma once
 
+#include "gpu_statistics.hpp"
+#include "image.hpp"
 #include "uniform.hpp"
 
+#include <chrono>
 #include <filesystem>
+#include <functional>
 #include <map>
+#include <string>
 #include <vector>
 
 namespace renderer
 {
 
+class Cost_Overlay;
+class Deep_Zoom;
+class Framebuffer;
+class Gpu_Profiler;
+class Quality_Governor;
+class Readback_Ring;
 class Shader;
+class Tile_Cache;
+
+namespace gl
+{
+class Fence_Queue;
+} // namespace gl
 
 class Renderer
 {
@@ -27,12 +44,166 @@ public:
 
 	void set_uniform (Uniform const& uniform_data);
 
-	void render (unsigned int width, unsigned int height);
+	// Frames which take longer than the budget are split into tiles drawn
+	//  over several calls to render. A budget of zero disables tiling.
+	void set_frame_budget (float milliseconds);
+
+	// While the camera moves frames are rendered at a reduced resolution and
+	//  budget, chosen from the measured GPU time to meet the target frame
+	//  time, and upscaled to the target. A target of zero always renders at
+	//  full quality.
+	void set_target_frame_time (float milliseconds);
+	void set_minimum_render_scale (float scale);
+	void notify_interaction();
+
+	// While the camera of a 2D shader moves, frames are instead composed of
+	//  full quality tiles of the plane which are kept between frames, only
+	//  the tiles uncovered by panning or zooming are rendered. The least
+	//  recently used tiles are dropped beyond the budget, 256 MB by default.
+	//  A budget of zero disables the cache.
+	void set_tile_cache_budget (unsigned int megabytes);
+
+	// Zooms the Mandelbrot and Julia sets past where float coordinates run
+	//  out, down to widths of about 1e-300. The view is centred on a point
+	//  given in decimal to as many digits as the zoom needs and the camera
+	//  uniforms are ignored until disabled. A background thread iterates the
+	//  centre at full precision, the shaders only iterate the offsets of the
+	//  pixels from it. Returns false if the centre is not a number or the
+	//  current shader can not deep zoom.
+	bool set_deep_zoom (
+		std::string const& real,
+		std::string const& imaginary,
+		double             width);
+	void disable_deep_zoom();
+
+	// Unsigned integer uniforms which cap the work per pixel, such as ray
+	//  march steps or fractal iterations. While the camera moves they are
+	//  lowered along with the resolution, down to the minimum fraction of the
+	//  value last set.
+	void set_budget_uniforms (std::vector<std::string> const& names);
+	void set_minimum_budget (float fraction);
+
+	// Blends a heatmap of the ray march steps or fractal iterations of each
+	//  pixel over the frame, red where a pixel used its whole budget. While
+	//  enabled frames are drawn whole, without tiles or reduced resolution.
+	void set_cost_overlay (bool enabled);
+
+	// Pixels of the last frame drawn with the overlay, counted by the fraction
+	//  of their step or iteration budget which they used, and the steps or
+	//  iterations they took on average.
+	std::vector<unsigned int> get_cost_histogram (unsigned int bins) const;
+	double                    get_mean_cost() const;
+
+	// Ray marching shaders first march cones through the frame at low
+	//  resolution, so that each pixel starts from the closest distance at
+	//  which its neighbourhood can hold a surface. Enabled by default.
+	void set_cone_prepass (bool enabled);
+
+	// Ray march steps which the prepass saved the last frame, summed over
+	//  its pixels. Reads back from the GPU, so it waits for the frame.
+	unsigned long long get_skipped_steps() const;
+
+	// Ray marching and fractal shaders write the hits or iterations of each
+	//  pixel to a G-buffer and colour the frame from it in a separate pass.
+	//  Changing a uniform which only the colouring reads then reruns just
+	//  that pass. Enabled by default.
+	void set_deferred_shading (bool enabled);
+
+	// Returns false while the frame still has tiles left to draw, the caller
+	//  should present the partial result and call render again.
+	bool render (unsigned int width, unsigned int height);
+
+	// Renders a whole frame into an offscreen target and reads it back.
+	Image render_image (unsigned int width, unsigned int height);
+
+	// Queues a read back of the frame last rendered into the bound
+	//  framebuffer without waiting for the GPU. The callback receives the
+	//  image on a worker thread once the copy finished, usually one or two
+	//  frames later, and may encode or write it there.
+	void capture_frame (
+		unsigned int                       width,
+		unsigned int                       height,
+		std::function<void (Image)> const& callback);
+
+	// Renders a whole frame offscreen as render_image does, but reads it back
+	//  through capture_frame so the next frame can be drawn while this one is
+	//  still being copied and encoded.
+	void render_capture (
+		unsigned int                       width,
+		unsigned int                       height,
+		std::function<void (Image)> const& callback);
+
+	// Hands finished captures to the worker, render does this every frame.
+	//  When waiting, returns once every capture has reached its callback.
+	void poll_captures (bool wait = false);
+	bool has_pending_captures() const;
+
+	// Calls back on the render thread once the GPU has finished everything
+	//  drawn so far, with the time this was noticed. Render checks every
+	//  frame, has_pending_notifications tells whether another frame is
+	//  needed to see the rest.
+	void notify_when_complete (
+		std::function<void (std::chrono::steady_clock::time_point)> callback);
+	bool has_pending_notifications() const;
+
+	// How many captures may be in flight before capturing waits for the
+	//  oldest one, three by default.
+	void set_frames_in_flight (unsigned int frames);
+
+	// GPU time per frame of every shader rendered so far, keyed by the name
+	//  of the shader file. Frames still on the GPU are only included when
+	//  waiting.
+	std::map<std::string, Gpu_Statistics>
+	get_gpu_statistics (bool wait = false);
+
+	// GPU time of the latest finished frame of the current shader, cheap
+	//  enough to be read every frame.
+	float get_last_gpu_frame_time() const;
+
+	// Renders a frame too large for a single framebuffer in square tiles and
+	//  streams each finished row of tiles to a PNG or PPM, so memory use is
+	//  bounded by one row of tiles. Finished rows are recorded in a checkpoint
+	//  next to the output, rerunning the same job resumes after them. The
+	//  job is a single line describing the render, such as its shader and
+	//  uniforms, progress receives the finished and total rows of tiles.
+	bool render_tiled (
+		std::filesystem::path const&                            output,
+		unsigned int                                            width,
+		unsigned int                                            height,
+		unsigned int                                            tile_size,
+		std::string const&                                      job,
+		std::function<void (unsigned int, unsigned int)> const& progress
+		= {});
 
 private:
 	// Using a pointer in order to not include shader.hpp which would need to
 	//  to be accessible outside of the library.
-	renderer::Shader* shader = nullptr;
+	renderer::Shader*           shader         = nullptr;
+	renderer::Framebuffer*      scaled_target  = nullptr;
+	renderer::Framebuffer*      capture_target = nullptr;
+	renderer::Quality_Governor* governor       = nullptr;
+	renderer::Readback_Ring*    readback       = nullptr;
+	renderer::Gpu_Profiler*     profiler       = nullptr;
+	renderer::Cost_Overlay*     cost_overlay   = nullptr;
+	renderer::gl::Fence_Queue*  completions    = nullptr;
+	renderer::Tile_Cache*       tile_cache     = nullptr;
+	renderer::Deep_Zoom*        deep_zoom      = nullptr;
+
+	unsigned int resolution_width  = 0;
+	unsigned int resolution_height = 0;
+	bool         rendered_scaled   = false;
+
+	std::filesystem::path include_path;
+	bool                  cost_overlay_enabled = false;
+
+	// Values of the budget uniforms last uploaded to the shader.
+	std::map<std::string, unsigned int> uploaded_budgets;
+
+	void apply_budgets (std::map<std::string, unsigned int> const& budgets);
+	void collect_frame_times (bool wait = false);
+	void draw_frame (unsigned int width, unsigned int height);
+	void render_scaled (unsigned int width, unsigned int height);
+	void update_resolution (unsigned int width, unsigned int height);
 };
 
 } // namespace renderer
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+
+// Scoped zones written as Chrome trace events, which chrome://tracing and
+//  Perfetto show on a timeline per thread. Setting the RENDERER_TRACE
+//  environment variable to a file path records from start up until the
+//  program exits. While not recording a zone costs a relaxed atomic load.
+#define TRACE_SCOPE(name) \
+	renderer::trace::Scope TRACE_CONCATENATE (trace_scope_, __LINE__) (name)
+
+#define TRACE_CONCATENATE(a, b)          TRACE_CONCATENATE_EXPANDED (a, b)
+#define TRACE_CONCATENATE_EXPANDED(a, b) a##b
+
+namespace renderer::trace
+{
+
+// Zones recorded until stop are written to the path.
+void start (std::filesystem::path const& path);
+void stop();
+
+namespace detail
+{
+extern std::atomic<bool> recording;
+
+std::uint64_t now();
+void record (char const* name, std::uint64_t begin, std::uint64_t end);
+} // namespace detail
+
+inline bool is_recording()
+{
+	return detail::recording.load (std::memory_order_relaxed);
+}
+
+// The name is kept as a pointer, it should be a string literal.
+class Scope
+{
+public:
+	explicit Scope (char const* p_name)
+		: name (is_recording() ? p_name : nullptr)
+		, begin (name != nullptr ? detail::now() : 0)
+	{
+	}
+
+	~Scope()
+	{
+		if (name != nullptr)
+		{
+			detail::record (name, begin, detail::now());
+		}
+	}
+
+	Scope (Scope const&) = delete;
+	Scope& operator= (Scope const&) = delete;
+
+private:
+	char const* const   name;
+	const std::uint64_t begin;
+};
+
+} // namespace renderer::trace
@@ -0,0 +1,166 @@
+#include "readback_ring.hpp"
+
+#include "trace.hpp"
+
+#include <cstring>
+#include <iostream>
+
+namespace renderer
+{
+
+Image image_from_readback (
+	unsigned int                     width,
+	unsigned int                     height,
+	std::vector<std::uint8_t> const& rgba)
+{
+	Image image{width, height, std::vector<std::uint8_t> (rgba.size() / 4 * 3)};
+	for (size_t row = 0; row < height; ++row)
+	{
+		std::uint8_t const* source      = &rgba[(height - 1 - row) * width * 4];
+		std::uint8_t*       destination = &image.pixels[row * width * 3];
+		for (size_t column = 0; column < width; ++column)
+		{
+			destination[column * 3 + 0] = source[column * 4 + 0];
+			destination[column * 3 + 1] = source[column * 4 + 1];
+			destination[column * 3 + 2] = source[column * 4 + 2];
+		}
+	}
+	return image;
+}
+
+Readback_Ring::Readback_Ring (size_t slot_count) : slots (slot_count)
+{
+	for (Slot& slot : slots)
+	{
+		glGenBuffers (1, &slot.buffer);
+	}
+}
+
+Readback_Ring::~Readback_Ring()
+{
+	poll (true);
+	for (Slot& slot : slots)
+	{
+		glDeleteBuffers (1, &slot.buffer);
+	}
+}
+
+void Readback_Ring::read (
+	unsigned int width,
+	unsigned int height,
+	Callback     callback)
+{
+	TRACE_SCOPE ("Readback_Ring::read");
+	Slot& slot = slots[next_slot];
+	if (slot.fence != nullptr)
+	{
+		// The ring is full, the oldest copy is the one in this slot.
+		collect (slot, true);
+		in_flight.pop_front();
+	}
+
+	slot.width    = width;
+	slot.height   = height;
+	slot.callback = std::move (callback);
+
+	const size_t size = size_t{width} * height * 4;
+	glBindBuffer (GL_PIXEL_PACK_BUFFER, slot.buffer);
+	if (size != slot.capacity)
+	{
+		glBufferData (
+			GL_PIXEL_PACK_BUFFER,
+			static_cast<GLsizeiptr> (size),
+			nullptr,
+			GL_STREAM_READ);
+		slot.capacity = size;
+	}
+
+	glPixelStorei (GL_PACK_ALIGNMENT, 1);
+	glReadPixels (
+		0,
+		0,
+		static_cast<GLsizei> (width),
+		static_cast<GLsizei> (height),
+		GL_RGBA,
+		GL_UNSIGNED_BYTE,
+		nullptr);
+	glBindBuffer (GL_PIXEL_PACK_BUFFER, 0);
+
+	// Flushing makes sure the fence is submitted, otherwise polling it
+	//  without waiting could never see it signal.
+	slot.fence = glFenceSync (GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	glFlush();
+
+	in_flight.push_back (next_slot);
+	next_slot = (next_slot + 1) % slots.size();
+}
+
+void Readback_Ring::poll (bool wait)
+{
+	while (!in_flight.empty() && collect (slots[in_flight.front()], wait))
+	{
+		in_flight.pop_front();
+	}
+
+	if (wait)
+	{
+		worker.wait_idle();
+	}
+}
+
+bool Readback_Ring::is_pending() const
+{
+	return !in_flight.empty();
+}
+
+bool Readback_Ring::collect (Slot& slot, bool wait)
+{
+	const GLuint64 timeout = wait ? GL_TIMEOUT_IGNORED : 0;
+	const GLenum   status
+		= glClientWaitSync (slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+	if (status == GL_TIMEOUT_EXPIRED)
+	{
+		return false;
+	}
+	glDeleteSync (slot.fence);
+	slot.fence = nullptr;
+
+	if (status == GL_WAIT_FAILED)
+	{
+		std::cerr << "Waiting for a frame read back failed.\n";
+		return true;
+	}
+
+	TRACE_SCOPE ("Readback_Ring::collect");
+
+	// Only the copy out of the mapped buffer happens here, converting and
+	//  encoding is left to the worker.
+	std::vector<std::uint8_t> rgba (slot.capacity);
+	glBindBuffer (GL_PIXEL_PACK_BUFFER, slot.buffer);
+	void const* mapped = glMapBufferRange (
+		GL_PIXEL_PACK_BUFFER,
+		0,
+		static_cast<GLsizeiptr> (slot.capacity),
+		GL_MAP_READ_BIT);
+	if (mapped != nullptr)
+	{
+		std::memcpy (rgba.data(), mapped, rgba.size());
+		glUnmapBuffer (GL_PIXEL_PACK_BUFFER);
+	}
+	else
+	{
+		std::cerr << "Mapping a frame read back failed.\n";
+	}
+	glBindBuffer (GL_PIXEL_PACK_BUFFER, 0);
+
+	worker.post ([width    = slot.width,
+				  height   = slot.height,
+				  callback = std::move (slot.callback),
+				  rgba     = std::move (rgba)] {
+		TRACE_SCOPE ("Readback_Ring::deliver");
+		callback (image_from_readback (width, height, rgba));
+	});
+	return true;
+}
+
+} // namespace renderer
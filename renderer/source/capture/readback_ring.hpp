@@ -0,0 +1,70 @@
+#pragma once
+
+#include "image.hpp"
+#include "worker.hpp"
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace renderer
+{
+
+// Converts RGBA rows read from OpenGL, which start at the bottom of the
+//  frame, into a top down RGB image.
+Image image_from_readback (
+	unsigned int                     width,
+	unsigned int                     height,
+	std::vector<std::uint8_t> const& rgba);
+
+// Reads frames back through a ring of pixel buffer objects. Reading into a
+//  buffer object returns immediately, a fence tells when the copy finished so
+//  that mapping it never stalls the pipeline. Finished frames are converted
+//  and handed to their callback on a worker thread.
+class Readback_Ring
+{
+public:
+	using Callback = std::function<void (Image)>;
+
+	Readback_Ring (size_t slot_count = 3);
+	~Readback_Ring();
+
+	Readback_Ring (Readback_Ring const&) = delete;
+	Readback_Ring& operator= (Readback_Ring const&) = delete;
+
+	// Queues a copy of the bound read framebuffer. When every slot is in
+	//  flight this waits for the oldest one.
+	void read (unsigned int width, unsigned int height, Callback callback);
+
+	// Collects the copies which finished, or all of them when waiting. After
+	//  waiting every callback has also returned.
+	void poll (bool wait = false);
+
+	bool is_pending() const;
+
+private:
+	struct Slot
+	{
+		GLuint       buffer   = 0;
+		GLsync       fence    = nullptr;
+		size_t       capacity = 0;
+		unsigned int width    = 0;
+		unsigned int height   = 0;
+		Callback     callback;
+	};
+
+	std::vector<Slot>  slots;
+	std::deque<size_t> in_flight;
+	size_t             next_slot = 0;
+
+	Worker worker;
+
+	// Returns false if the copy has not finished and waiting was not asked
+	//  for.
+	bool collect (Slot& slot, bool wait);
+};
+
+} // namespace renderer
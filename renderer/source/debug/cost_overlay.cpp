@@ -0,0 +1,151 @@
+#include "cost_overlay.hpp"
+
+#include "gl_interface.hpp"
+#include "parser.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+namespace renderer
+{
+
+Cost_Overlay::Cost_Overlay() = default;
+
+Cost_Overlay::~Cost_Overlay()
+{
+	glDeleteProgram (program_id);
+}
+
+bool Cost_Overlay::load (std::filesystem::path const& include_path)
+{
+	if (program_id != 0)
+	{
+		return true;
+	}
+
+	preprocessor::Parser parser (
+		include_path,
+		include_path / "debug" / "cost_heatmap.frag");
+	if (!parser.is_valid())
+	{
+		for (std::string const& error : parser.get_errors())
+		{
+			std::cerr << error;
+		}
+		return false;
+	}
+
+	auto [success, new_program_id] = gl::create_program (
+		parser.get_vertex_shader_code(),
+		parser.get_fragment_shader_code());
+	if (!success)
+	{
+		return false;
+	}
+	program_id = new_program_id;
+
+	glUseProgram (program_id);
+	for (std::unique_ptr<Uniform> const& uniform : parser.get_uniforms())
+	{
+		gl::set_uniform (program_id, *uniform);
+	}
+	gl::set_uniform (program_id, Typed_Uniform<int> ("frame_colour", {0}));
+	gl::set_uniform (program_id, Typed_Uniform<int> ("frame_cost", {1}));
+	glUseProgram (0);
+	return true;
+}
+
+void Cost_Overlay::draw (
+	unsigned int                 width,
+	unsigned int                 height,
+	std::function<void()> const& draw_frame)
+{
+	GLint target_framebuffer = 0;
+	glGetIntegerv (GL_DRAW_FRAMEBUFFER_BINDING, &target_framebuffer);
+
+	frame.resize (width, height);
+	frame.bind();
+	draw_frame();
+
+	glBindFramebuffer (
+		GL_FRAMEBUFFER,
+		static_cast<GLuint> (target_framebuffer));
+	glUseProgram (program_id);
+	glActiveTexture (GL_TEXTURE0);
+	glBindTexture (GL_TEXTURE_2D, frame.get_texture (0));
+	glActiveTexture (GL_TEXTURE1);
+	glBindTexture (GL_TEXTURE_2D, frame.get_texture (1));
+	screen_vertices.render();
+	glBindTexture (GL_TEXTURE_2D, 0);
+	glActiveTexture (GL_TEXTURE0);
+	glBindTexture (GL_TEXTURE_2D, 0);
+	glUseProgram (0);
+}
+
+std::vector<unsigned int> Cost_Overlay::histogram (unsigned int bins) const
+{
+	std::vector<unsigned int> counts (bins, 0);
+	if (bins == 0)
+	{
+		return counts;
+	}
+
+	const std::vector<float> costs = read_costs();
+	for (size_t i = 0; i < costs.size(); i += 2)
+	{
+		const float cost   = costs[i];
+		const float budget = costs[i + 1];
+		const float used   = budget > 0.0f ? cost / budget : 0.0f;
+		const auto  bin    = static_cast<unsigned int> (used * bins);
+		++counts[std::min (bin, bins - 1)];
+	}
+	return counts;
+}
+
+double Cost_Overlay::mean_cost() const
+{
+	const std::vector<float> costs = read_costs();
+	if (costs.empty())
+	{
+		return 0.0;
+	}
+
+	double total = 0.0;
+	for (size_t i = 0; i < costs.size(); i += 2)
+	{
+		total += costs[i];
+	}
+	return total * 2.0 / static_cast<double> (costs.size());
+}
+
+std::vector<float> Cost_Overlay::read_costs() const
+{
+	const size_t pixels = size_t{frame.get_width()} * frame.get_height();
+	if (pixels == 0)
+	{
+		return {};
+	}
+
+	GLint previous_framebuffer = 0;
+	glGetIntegerv (GL_READ_FRAMEBUFFER_BINDING, &previous_framebuffer);
+
+	std::vector<float> costs (pixels * 2);
+	glBindFramebuffer (GL_READ_FRAMEBUFFER, frame.get_id());
+	glReadBuffer (GL_COLOR_ATTACHMENT1);
+	glPixelStorei (GL_PACK_ALIGNMENT, 1);
+	glReadPixels (
+		0,
+		0,
+		static_cast<GLsizei> (frame.get_width()),
+		static_cast<GLsizei> (frame.get_height()),
+		GL_RG,
+		GL_FLOAT,
+		costs.data());
+	glReadBuffer (GL_COLOR_ATTACHMENT0);
+	glBindFramebuffer (
+		GL_READ_FRAMEBUFFER,
+		static_cast<GLuint> (previous_framebuffer));
+	return costs;
+}
+
+} // namespace renderer
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "framebuffer.hpp"
+#include "screen_vertex_array.hpp"
+
+#include <GL/glew.h>
+
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+namespace renderer
+{
+
+// Shows the ray march steps or fractal iterations of every pixel as a
+//  heatmap over the frame. The shaders write their cost to a second colour
+//  attachment, which is only bound while the overlay is in use.
+class Cost_Overlay
+{
+public:
+	Cost_Overlay();
+	~Cost_Overlay();
+
+	Cost_Overlay (Cost_Overlay const&) = delete;
+	Cost_Overlay& operator= (Cost_Overlay const&) = delete;
+
+	// Compiles debug/cost_heatmap.frag, returns false if it failed.
+	bool load (std::filesystem::path const& include_path);
+
+	// Draws the frame with its cost attachment offscreen and blends the
+	//  heatmap over it into the bound framebuffer.
+	void draw (
+		unsigned int                 width,
+		unsigned int                 height,
+		std::function<void()> const& draw_frame);
+
+	// Counts the pixels of the last frame by the fraction of their budget
+	//  which they used. The bins split the budget evenly, pixels which used
+	//  all of it fall in the last one.
+	std::vector<unsigned int> histogram (unsigned int bins) const;
+
+	// Steps or iterations per pixel of the last frame, on average.
+	double mean_cost() const;
+
+private:
+	GLuint              program_id = 0;
+	Screen_Vertex_Array screen_vertices;
+	Framebuffer         frame{{GL_RGBA8, GL_RG32F}};
+
+	// The cost and budget of every pixel, interleaved.
+	std::vector<float> read_costs() const;
+};
+
+} // namespace renderer
@@ -0,0 +1,366 @@
+#include "deep_zoom.hpp"
+
+#include "shader.hpp"
+#include "trace.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace renderer
+{
+
+namespace
+{
+bool ends_with (std::string const& text, std::string const& suffix)
+{
+	return text.size() >= suffix.size()
+		   && text.compare (text.size() - suffix.size(), suffix.size(), suffix)
+				  == 0;
+}
+
+bool same_point (
+	Fixed_Point const& real,
+	Fixed_Point const& imaginary,
+	Fixed_Point const& other_real,
+	Fixed_Point const& other_imaginary)
+{
+	return (real - other_real).to_double() == 0.0
+		   && (imaginary - other_imaginary).to_double() == 0.0;
+}
+} // namespace
+
+Deep_Zoom::Deep_Zoom (Shader& p_shader) : shader (p_shader) {}
+
+Deep_Zoom::~Deep_Zoom()
+{
+	// Stops the orbit in progress at its next check.
+	++latest_request;
+	worker.wait_idle();
+	glDeleteTextures (1, &texture);
+}
+
+void Deep_Zoom::set_shader (
+	std::vector<std::unique_ptr<Uniform>> const& uniforms)
+{
+	supported      = false;
+	julia          = false;
+	shader_enabled = false;
+	for (std::unique_ptr<Uniform> const& uniform : uniforms)
+	{
+		const std::string name = uniform->get_name();
+		const auto        vector
+			= dynamic_cast<const Typed_Uniform<float>*> (uniform.get());
+		const auto count
+			= dynamic_cast<const Typed_Uniform<unsigned int>*> (uniform.get());
+		if (name == "deep_zoom.enabled")
+		{
+			supported = true;
+		}
+		else if (
+			name == "julia_set.constant" && vector != nullptr
+			&& vector->get_values().size() == 2)
+		{
+			julia       = true;
+			constant[0] = vector->get_values()[0];
+			constant[1] = vector->get_values()[1];
+		}
+		else if (
+			ends_with (name, ".iterations") && count != nullptr
+			&& count->get_values().size() == 1)
+		{
+			iterations = count->get_values()[0];
+		}
+	}
+
+	invalidate_orbit();
+	if (supported)
+	{
+		shader.set_uniform (
+			Typed_Uniform<int> ("reference_orbit", {texture_unit}));
+	}
+}
+
+void Deep_Zoom::set_uniform (Uniform const& uniform)
+{
+	if (!supported)
+	{
+		return;
+	}
+
+	const std::string name = uniform.get_name();
+	const auto vector = dynamic_cast<const Typed_Uniform<float>*> (&uniform);
+	const auto count
+		= dynamic_cast<const Typed_Uniform<unsigned int>*> (&uniform);
+	if (julia && name == "julia_set.constant" && vector != nullptr
+		&& vector->get_values().size() == 2)
+	{
+		if (vector->get_values()[0] != constant[0]
+			|| vector->get_values()[1] != constant[1])
+		{
+			constant[0] = vector->get_values()[0];
+			constant[1] = vector->get_values()[1];
+			invalidate_orbit();
+		}
+	}
+	else if (
+		ends_with (name, ".iterations") && count != nullptr
+		&& count->get_values().size() == 1)
+	{
+		// Fragments rebase when they outlive the reference, so a shorter
+		//  orbit only costs time until the longer one arrives.
+		iterations = count->get_values()[0];
+	}
+}
+
+bool Deep_Zoom::set_view (
+	std::string const& real,
+	std::string const& imaginary,
+	double             p_width)
+{
+	if (!(p_width > 0.0) || !std::isfinite (p_width))
+	{
+		return false;
+	}
+
+	// Enough limbs that the pixels are many bits above the last one.
+	const auto fraction_limbs = static_cast<unsigned int> (
+		std::max (2.0, std::ceil ((64.0 - std::log2 (p_width)) / 32.0)));
+	Fixed_Point new_real;
+	Fixed_Point new_imaginary;
+	if (!Fixed_Point::parse (real, fraction_limbs, new_real)
+		|| !Fixed_Point::parse (imaginary, fraction_limbs, new_imaginary)
+		|| std::abs (new_real.to_double()) > max_coordinate
+		|| std::abs (new_imaginary.to_double()) > max_coordinate)
+	{
+		return false;
+	}
+
+	centre_real      = new_real;
+	centre_imaginary = new_imaginary;
+	width            = p_width;
+	enabled          = true;
+	view_changed     = true;
+	return true;
+}
+
+void Deep_Zoom::disable()
+{
+	enabled = false;
+	if (shader_enabled)
+	{
+		shader.set_uniform (Typed_Uniform<bool> ("deep_zoom.enabled", {false}));
+		shader_enabled = false;
+	}
+}
+
+bool Deep_Zoom::is_active() const
+{
+	return supported && enabled;
+}
+
+void Deep_Zoom::update()
+{
+	if (!is_active())
+	{
+		return;
+	}
+
+	TRACE_SCOPE ("Deep_Zoom::update");
+	if (needs_orbit())
+	{
+		request_orbit();
+	}
+
+	bool uploaded = take_finished();
+	if (!current)
+	{
+		worker.wait_idle();
+		uploaded = take_finished();
+	}
+	if (current && (uploaded || view_changed || !shader_enabled))
+	{
+		upload_view();
+	}
+}
+
+void Deep_Zoom::invalidate_orbit()
+{
+	first_valid_request = latest_request + 1;
+	current.reset();
+	requested.reset();
+}
+
+bool Deep_Zoom::needs_orbit() const
+{
+	if (!requested
+		|| requested->real.get_fraction_limbs()
+			   < centre_real.get_fraction_limbs()
+		|| !same_point (
+			centre_real,
+			centre_imaginary,
+			requested->real,
+			requested->imaginary))
+	{
+		return true;
+	}
+
+	// An orbit which escaped does not get any longer.
+	const bool escaped = current && current->request == latest_request
+						 && current->escaped;
+	return iterations > requested->iterations && !escaped;
+}
+
+void Deep_Zoom::request_orbit()
+{
+	requested = Request{centre_real, centre_imaginary, iterations};
+
+	Orbit orbit;
+	orbit.real       = centre_real;
+	orbit.imaginary  = centre_imaginary;
+	orbit.iterations = iterations;
+	orbit.request    = ++latest_request;
+	worker.post (
+		[this,
+		 orbit              = std::move (orbit),
+		 julia_orbit        = julia,
+		 constant_real      = constant[0],
+		 constant_imaginary = constant[1]]() mutable
+		{
+			if (!compute_orbit (
+					orbit,
+					julia_orbit,
+					constant_real,
+					constant_imaginary))
+			{
+				return;
+			}
+
+			std::lock_guard<std::mutex> lock (finished_mutex);
+			finished = std::move (orbit);
+		});
+}
+
+bool Deep_Zoom::compute_orbit (
+	Orbit& orbit,
+	bool   julia_orbit,
+	float  constant_real,
+	float  constant_imaginary) const
+{
+	TRACE_SCOPE ("Deep_Zoom::compute_orbit");
+	const unsigned int limbs = orbit.real.get_fraction_limbs();
+
+	// The Mandelbrot set starts from zero and adds the centre, Julia sets
+	//  start from the centre and add their constant.
+	Fixed_Point real (limbs);
+	Fixed_Point imaginary (limbs);
+	Fixed_Point add_real      = orbit.real;
+	Fixed_Point add_imaginary = orbit.imaginary;
+	if (julia_orbit)
+	{
+		real          = orbit.real;
+		imaginary     = orbit.imaginary;
+		add_real      = Fixed_Point::from_double (constant_real, limbs);
+		add_imaginary = Fixed_Point::from_double (constant_imaginary, limbs);
+	}
+
+	orbit.values.reserve (2 * (size_t{orbit.iterations} + 1));
+	for (unsigned int n = 0;; ++n)
+	{
+		const double x = real.to_double();
+		const double y = imaginary.to_double();
+		orbit.values.push_back (static_cast<float> (x));
+		orbit.values.push_back (static_cast<float> (y));
+
+		// Fragments read the step after their own, so every orbit has at
+		//  least two.
+		orbit.escaped = x * x + y * y > escape_radius;
+		if (n >= 1 && (orbit.escaped || n >= orbit.iterations))
+		{
+			return true;
+		}
+
+		if (n % 256 == 0 && latest_request != orbit.request)
+		{
+			return false;
+		}
+
+		const Fixed_Point cross = real * imaginary;
+		real      = real * real - imaginary * imaginary + add_real;
+		imaginary = cross + cross + add_imaginary;
+	}
+}
+
+bool Deep_Zoom::take_finished()
+{
+	std::optional<Orbit> orbit;
+	{
+		std::lock_guard<std::mutex> lock (finished_mutex);
+		orbit.swap (finished);
+	}
+	if (!orbit || orbit->request < first_valid_request)
+	{
+		return false;
+	}
+
+	// Padded to whole rows.
+	const size_t length  = orbit->values.size() / 2;
+	const size_t columns = std::min<size_t> (length, orbit_columns);
+	const size_t rows    = (length + columns - 1) / columns;
+	orbit->values.resize (2 * columns * rows, 0.0f);
+
+	if (texture == 0)
+	{
+		glGenTextures (1, &texture);
+	}
+	glActiveTexture (GL_TEXTURE0 + texture_unit);
+	glBindTexture (GL_TEXTURE_2D, texture);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexImage2D (
+		GL_TEXTURE_2D,
+		0,
+		GL_RG32F,
+		static_cast<GLsizei> (columns),
+		static_cast<GLsizei> (rows),
+		0,
+		GL_RG,
+		GL_FLOAT,
+		orbit->values.data());
+	glActiveTexture (GL_TEXTURE0);
+
+	orbit_length = static_cast<int> (length);
+	orbit->values.clear();
+	orbit->values.shrink_to_fit();
+	current = std::move (orbit);
+	return true;
+}
+
+void Deep_Zoom::upload_view()
+{
+	// The exponent keeps the half width between one and two, offsets are in
+	//  the same units.
+	const double half     = 0.5 * width;
+	const int    exponent = std::ilogb (half);
+	const double scale    = std::ldexp (1.0, -exponent);
+	const double offset_real
+		= (centre_real - current->real).to_double() * scale;
+	const double offset_imaginary
+		= (centre_imaginary - current->imaginary).to_double() * scale;
+
+	shader.set_uniform (Typed_Uniform<bool> ("deep_zoom.enabled", {true}));
+	shader.set_uniform (Typed_Uniform<float> (
+		"deep_zoom.half_width",
+		{static_cast<float> (half * scale)}));
+	shader.set_uniform (Typed_Uniform<float> (
+		"deep_zoom.view_offset",
+		{static_cast<float> (offset_real),
+		 static_cast<float> (offset_imaginary)}));
+	shader.set_uniform (
+		Typed_Uniform<int> ("deep_zoom.exponent", {exponent}));
+	shader.set_uniform (
+		Typed_Uniform<int> ("deep_zoom.orbit_length", {orbit_length}));
+	view_changed   = false;
+	shader_enabled = true;
+}
+
+} // namespace renderer
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "fixed_point.hpp"
+#include "uniform.hpp"
+#include "worker.hpp"
+
+#include <GL/glew.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace renderer
+{
+
+class Shader;
+
+// Renders the 2D fractals around a centre given to any precision, zoomed
+//  far past where float coordinates run out. A worker thread iterates the
+//  centre in fixed point, the reference orbit, which is uploaded as a
+//  texture. Each fragment then only iterates its small offset from the
+//  reference in float, see 2d/deep_zoom.frag. Until the orbit of a new
+//  centre arrives the previous one is kept and the view is offset from its
+//  reference, so panning never waits for the worker.
+class Deep_Zoom
+{
+public:
+	explicit Deep_Zoom (Shader& shader);
+	~Deep_Zoom();
+
+	Deep_Zoom (Deep_Zoom const&) = delete;
+	Deep_Zoom& operator= (Deep_Zoom const&) = delete;
+
+	// Shaders with the deep_zoom uniforms of 2d/deep_zoom.frag can deep
+	//  zoom. The orbit is of the Mandelbrot set unless the shader has the
+	//  constant of a Julia set.
+	void set_shader (std::vector<std::unique_ptr<Uniform>> const& uniforms);
+
+	// Follows the uniforms the orbit depends on, the iterations and the
+	//  constant of Julia sets.
+	void set_uniform (Uniform const& uniform);
+
+	// Centres the view on the decimal coordinates, the view is the width
+	//  wide. Returns false if either coordinate is not a number or lies
+	//  beyond the escape radius.
+	bool set_view (
+		std::string const& real,
+		std::string const& imaginary,
+		double             width);
+	void disable();
+	bool is_active() const;
+
+	// Uploads the latest orbit and the view, before each frame. Only waits
+	//  for the worker while no orbit of the current fractal exists.
+	void update();
+
+private:
+	// The cone prepass binds the first unit and deferred shading the four
+	//  after it.
+	static constexpr GLint texture_unit = 5;
+
+	static constexpr unsigned int orbit_columns  = 1024;
+	static constexpr double       max_coordinate = 16.0;
+
+	// Squared, far enough past the fragments' escape that every fragment
+	//  near the reference has escaped before it.
+	static constexpr double escape_radius = 1024.0;
+
+	struct Orbit
+	{
+		Fixed_Point        real;
+		Fixed_Point        imaginary;
+		std::vector<float> values;
+		unsigned int       iterations = 0;
+		bool               escaped    = false;
+		unsigned long long request    = 0;
+	};
+
+	// What the latest request was for, to only request again when the view
+	//  needs another orbit.
+	struct Request
+	{
+		Fixed_Point  real;
+		Fixed_Point  imaginary;
+		unsigned int iterations = 0;
+	};
+
+	Shader& shader;
+
+	bool         supported      = false;
+	bool         enabled        = false;
+	bool         julia          = false;
+	float        constant[2]    = {0.0f, 0.0f};
+	unsigned int iterations     = 0;
+	bool         view_changed   = false;
+	bool         shader_enabled = false;
+
+	Fixed_Point centre_real;
+	Fixed_Point centre_imaginary;
+	double      width = 1.0;
+
+	// The orbit the texture holds, without its values.
+	GLuint                 texture      = 0;
+	int                    orbit_length = 0;
+	std::optional<Orbit>   current;
+	std::optional<Request> requested;
+
+	// Orbits of requests before the first valid one are of another fractal.
+	std::atomic<unsigned long long> latest_request{0};
+	unsigned long long              first_valid_request = 0;
+
+	std::mutex           finished_mutex;
+	std::optional<Orbit> finished;
+
+	// Last, so that its thread stops before the rest is destroyed.
+	Worker worker;
+
+	void invalidate_orbit();
+	bool needs_orbit() const;
+	void request_orbit();
+	bool compute_orbit (
+		Orbit& orbit,
+		bool   julia_orbit,
+		float  constant_real,
+		float  constant_imaginary) const;
+	bool take_finished();
+	void upload_view();
+};
+
+} // namespace renderer
@@ -0,0 +1,309 @@
+#include "fixed_point.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <limits>
+
+namespace renderer
+{
+
+Fixed_Point::Fixed_Point (unsigned int fraction_limbs)
+	: limbs (fraction_limbs + 1, 0)
+{
+}
+
+bool Fixed_Point::parse (
+	std::string const& decimal,
+	unsigned int       fraction_limbs,
+	Fixed_Point&       result)
+{
+	// Longer exponents are not needed to reach the smallest double.
+	constexpr int max_exponent = 10000;
+
+	size_t position = 0;
+	bool   negative = false;
+	if (position < decimal.size()
+		&& (decimal[position] == '-' || decimal[position] == '+'))
+	{
+		negative = decimal[position] == '-';
+		++position;
+	}
+
+	// The digits without the point, the point follows the first point_at.
+	std::string digits;
+	long long   point_at = -1;
+	for (; position < decimal.size(); ++position)
+	{
+		const char character = decimal[position];
+		if (std::isdigit (static_cast<unsigned char> (character)))
+		{
+			digits += character;
+		}
+		else if (character == '.' && point_at < 0)
+		{
+			point_at = static_cast<long long> (digits.size());
+		}
+		else
+		{
+			break;
+		}
+	}
+	if (digits.empty())
+	{
+		return false;
+	}
+	if (point_at < 0)
+	{
+		point_at = static_cast<long long> (digits.size());
+	}
+
+	if (position < decimal.size()
+		&& (decimal[position] == 'e' || decimal[position] == 'E'))
+	{
+		const std::string exponent = decimal.substr (position + 1);
+		size_t            parsed   = 0;
+		int               value    = 0;
+		try
+		{
+			value = std::stoi (exponent, &parsed);
+		}
+		catch (std::exception const& /* e */)
+		{
+			return false;
+		}
+		if (parsed != exponent.size() || std::abs (value) > max_exponent)
+		{
+			return false;
+		}
+		point_at += value;
+		position = decimal.size();
+	}
+	if (position != decimal.size())
+	{
+		return false;
+	}
+
+	if (point_at < 0)
+	{
+		digits.insert (0, static_cast<size_t> (-point_at), '0');
+		point_at = 0;
+	}
+	if (point_at > static_cast<long long> (digits.size()))
+	{
+		digits.append (static_cast<size_t> (point_at) - digits.size(), '0');
+	}
+
+	std::uint64_t integer = 0;
+	for (long long i = 0; i < point_at; ++i)
+	{
+		integer = integer * 10 + static_cast<std::uint64_t> (digits[i] - '0');
+		if (integer > std::numeric_limits<std::uint32_t>::max())
+		{
+			return false;
+		}
+	}
+
+	// Each limb is the carry out of the decimal fraction times 2^32.
+	std::vector<std::uint32_t> fraction (digits.size() - point_at);
+	for (size_t i = 0; i < fraction.size(); ++i)
+	{
+		fraction[i] = static_cast<std::uint32_t> (digits[point_at + i] - '0');
+	}
+
+	result          = Fixed_Point (fraction_limbs);
+	result.limbs[0] = static_cast<std::uint32_t> (integer);
+	for (unsigned int limb = 1; limb <= fraction_limbs; ++limb)
+	{
+		std::uint64_t carry = 0;
+		for (size_t i = fraction.size(); i-- > 0;)
+		{
+			const std::uint64_t value
+				= (std::uint64_t{fraction[i]} << 32) + carry;
+			fraction[i] = static_cast<std::uint32_t> (value % 10);
+			carry       = value / 10;
+		}
+		result.limbs[limb] = static_cast<std::uint32_t> (carry);
+	}
+
+	result.negative
+		= negative
+		  && std::any_of (
+			  result.limbs.begin(),
+			  result.limbs.end(),
+			  [] (std::uint32_t limb) { return limb != 0; });
+	return true;
+}
+
+Fixed_Point Fixed_Point::from_double (double value, unsigned int fraction_limbs)
+{
+	Fixed_Point result (fraction_limbs);
+	result.negative = value < 0.0;
+
+	double magnitude = std::min (
+		std::abs (value),
+		static_cast<double> (std::numeric_limits<std::uint32_t>::max()));
+	for (std::uint32_t& limb : result.limbs)
+	{
+		const double whole = std::floor (magnitude);
+		limb               = static_cast<std::uint32_t> (whole);
+		magnitude          = std::ldexp (magnitude - whole, 32);
+	}
+	return result;
+}
+
+Fixed_Point Fixed_Point::operator+ (Fixed_Point const& other) const
+{
+	return add (other, false);
+}
+
+Fixed_Point Fixed_Point::operator- (Fixed_Point const& other) const
+{
+	return add (other, true);
+}
+
+Fixed_Point Fixed_Point::operator* (Fixed_Point const& other) const
+{
+	const Fixed_Point right = other.with_precision (get_fraction_limbs());
+	const size_t      size  = limbs.size();
+
+	// Schoolbook multiplication, the product of limbs i and j lands in limb
+	//  i + j. The extra limb in front takes the carry out of the integer part
+	//  and is dropped.
+	std::vector<std::uint32_t> product (2 * size, 0);
+	for (size_t i = size; i-- > 0;)
+	{
+		std::uint64_t carry = 0;
+		for (size_t j = size; j-- > 0;)
+		{
+			const std::uint64_t value = std::uint64_t{limbs[i]} * right.limbs[j]
+										+ product[i + j + 1] + carry;
+			product[i + j + 1] = static_cast<std::uint32_t> (value);
+			carry              = value >> 32;
+		}
+		product[i] = static_cast<std::uint32_t> (carry);
+	}
+
+	Fixed_Point result (get_fraction_limbs());
+	std::copy (
+		product.begin() + 1,
+		product.begin() + 1 + static_cast<std::ptrdiff_t> (size),
+		result.limbs.begin());
+	result.negative
+		= (negative != right.negative)
+		  && std::any_of (
+			  result.limbs.begin(),
+			  result.limbs.end(),
+			  [] (std::uint32_t limb) { return limb != 0; });
+	return result;
+}
+
+double Fixed_Point::to_double() const
+{
+	auto first = std::find_if (
+		limbs.begin(),
+		limbs.end(),
+		[] (std::uint32_t limb) { return limb != 0; });
+
+	// Three limbs hold more bits than a double.
+	double value = 0.0;
+	for (auto limb = first; limb != limbs.end() && limb - first < 3; ++limb)
+	{
+		value += std::ldexp (
+			static_cast<double> (*limb),
+			-32 * static_cast<int> (limb - limbs.begin()));
+	}
+	return negative ? -value : value;
+}
+
+unsigned int Fixed_Point::get_fraction_limbs() const
+{
+	return static_cast<unsigned int> (limbs.size() - 1);
+}
+
+bool Fixed_Point::magnitude_less (
+	std::vector<std::uint32_t> const& a,
+	std::vector<std::uint32_t> const& b)
+{
+	return std::lexicographical_compare (
+		a.begin(),
+		a.end(),
+		b.begin(),
+		b.end());
+}
+
+std::vector<std::uint32_t> Fixed_Point::magnitude_add (
+	std::vector<std::uint32_t> const& a,
+	std::vector<std::uint32_t> const& b)
+{
+	std::vector<std::uint32_t> sum (a.size());
+	std::uint64_t              carry = 0;
+	for (size_t i = a.size(); i-- > 0;)
+	{
+		const std::uint64_t value = std::uint64_t{a[i]} + b[i] + carry;
+		sum[i]                    = static_cast<std::uint32_t> (value);
+		carry                     = value >> 32;
+	}
+	return sum;
+}
+
+std::vector<std::uint32_t> Fixed_Point::magnitude_subtract (
+	std::vector<std::uint32_t> const& larger,
+	std::vector<std::uint32_t> const& smaller)
+{
+	std::vector<std::uint32_t> difference (larger.size());
+	std::int64_t               borrow = 0;
+	for (size_t i = larger.size(); i-- > 0;)
+	{
+		std::int64_t value
+			= std::int64_t{larger[i]} - std::int64_t{smaller[i]} - borrow;
+		borrow = value < 0 ? 1 : 0;
+		if (value < 0)
+		{
+			value += std::int64_t{1} << 32;
+		}
+		difference[i] = static_cast<std::uint32_t> (value);
+	}
+	return difference;
+}
+
+Fixed_Point Fixed_Point::with_precision (unsigned int fraction_limbs) const
+{
+	Fixed_Point result = *this;
+	result.limbs.resize (fraction_limbs + 1, 0);
+	return result;
+}
+
+Fixed_Point Fixed_Point::add (Fixed_Point const& other, bool negate_other) const
+{
+	const Fixed_Point right = other.with_precision (get_fraction_limbs());
+	const bool right_negative = right.negative != negate_other;
+
+	Fixed_Point result (get_fraction_limbs());
+	if (negative == right_negative)
+	{
+		result.limbs    = magnitude_add (limbs, right.limbs);
+		result.negative = negative;
+	}
+	else if (magnitude_less (limbs, right.limbs))
+	{
+		result.limbs    = magnitude_subtract (right.limbs, limbs);
+		result.negative = right_negative;
+	}
+	else
+	{
+		result.limbs    = magnitude_subtract (limbs, right.limbs);
+		result.negative = negative;
+	}
+
+	if (std::all_of (
+			result.limbs.begin(),
+			result.limbs.end(),
+			[] (std::uint32_t limb) { return limb == 0; }))
+	{
+		result.negative = false;
+	}
+	return result;
+}
+
+} // namespace renderer
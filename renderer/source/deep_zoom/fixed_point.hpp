@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace renderer
+{
+
+// A signed number with a 32 bit integer part and a chosen number of 32 bit
+//  fraction limbs, for coordinates of the plane far more precise than a
+//  double. Products are truncated to the precision of the left operand.
+class Fixed_Point
+{
+public:
+	explicit Fixed_Point (unsigned int fraction_limbs = 2);
+
+	// Parses a decimal such as -0.75, 1.5e-3 or .25, returns false for
+	//  anything else.
+	static bool parse (
+		std::string const& decimal,
+		unsigned int       fraction_limbs,
+		Fixed_Point&       result);
+
+	static Fixed_Point from_double (double value, unsigned int fraction_limbs);
+
+	Fixed_Point operator+ (Fixed_Point const& other) const;
+	Fixed_Point operator- (Fixed_Point const& other) const;
+	Fixed_Point operator* (Fixed_Point const& other) const;
+
+	// Rounds to the nearest double, exact down to the smallest double for
+	//  small values since only the leading limbs are read.
+	double to_double() const;
+
+	unsigned int get_fraction_limbs() const;
+
+private:
+	// Most significant first, the integer part is the first limb.
+	std::vector<std::uint32_t> limbs;
+	bool                       negative = false;
+
+	// Magnitudes of equal precision.
+	static bool magnitude_less (
+		std::vector<std::uint32_t> const& a,
+		std::vector<std::uint32_t> const& b);
+	static std::vector<std::uint32_t> magnitude_add (
+		std::vector<std::uint32_t> const& a,
+		std::vector<std::uint32_t> const& b);
+	static std::vector<std::uint32_t> magnitude_subtract (
+		std::vector<std::uint32_t> const& larger,
+		std::vector<std::uint32_t> const& smaller);
+
+	Fixed_Point with_precision (unsigned int fraction_limbs) const;
+	Fixed_Point add (Fixed_Point const& other, bool negate_other) const;
+};
+
+} // namespace renderer
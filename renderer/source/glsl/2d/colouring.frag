@@ -7,10 +7,16 @@ uint  get_iterations();
 uint  get_max_iterations();
 float get_step();
 
-vec3 colour (float distance, float hit_distance, float time)
+// Iterations with the fraction by which the last step overshot the escape
+//  radius, which keeps the palette from banding.
+float smooth_iterations()
+{
+	return float (get_iterations()) + 1.0 - log2 (0.5 * log2 (get_step()));
+}
+
+vec3 palette (float iterations, float time)
 {
-	float co = (float (get_iterations()) + 1.0 - log2 (0.5 * log2 (get_step())))
-			   / float (get_max_iterations());
+	float co = iterations / float (get_max_iterations());
 	vec3 colour = vec3 (6.2831 * sqrt (co))
 				  + abs (colouring.background_colour - vec3 (time));
 	return 0.5f
@@ -19,3 +25,8 @@ vec3 colour (float distance, float hit_distance, float time)
 			   abs (cos (colour.y)),
 			   abs (cos (colour.z)));
 }
+
+vec3 colour (float distance, float hit_distance, float time)
+{
+	return palette (smooth_iterations(), time);
+}
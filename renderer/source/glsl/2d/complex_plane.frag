@@ -1,9 +1,18 @@
 #requires_implementation
 #vertex_shader "2d/complex_plane.vert"
 
-#include "2d/colouring.frag"
 #include "structures.glsl"
 
+// Zooming runs out of mediump long before it runs out of float. Set before
+//  the colouring, whose prototypes the fractals implement. Integers too, as
+//  floats converted from them take their precision.
+precision highp float;
+precision highp int;
+precision highp sampler2D;
+
+#include "2d/colouring.frag"
+#include "utility.frag"
+
 struct Complex_Plane
 {
 	float hit_distance = 0.0001;
@@ -15,19 +24,91 @@ uniform Fragment_Globals f_globals;
 uniform Camera_2d camera;
 
 in vec2 f_position;
+in vec2 f_view_position;
+flat in int f_double_float;
+
+#ifdef G_BUFFER
+// Smoothed iterations, squared magnitude of the last step, distance and
+//  iterations of each pixel, coloured by the DEFERRED_SHADING variant.
+layout (location = 0) out vec4 g_buffer;
+#else
+layout (location = 0) out vec4 fragment_colour;
 
-out vec4 fragment_colour;
+// Iterations taken and the iteration budget, for the cost overlay. The
+//  output is dropped unless a second colour attachment is bound.
+layout (location = 1) out vec2 fragment_cost;
+#endif
+
+#ifdef DEFERRED_SHADING
+uniform sampler2D g_buffer_0;
+#endif
 
 float DE (vec2 position);
 vec3  colour (float distance, float hit_distance);
 
-vec3 shade (vec2 position)
+#ifdef DEEP_ZOOM
+// Fractals which deep zoom implement these with 2d/deep_zoom.frag.
+bool  deep_zoom_enabled();
+float deep_zoom_DE (vec2 view_position);
+#endif
+
+#ifdef DOUBLE_FLOAT
+// Fractals which iterate in double-float implement this, see df64 in
+//  utility.frag.
+float double_float_DE (vec4 position);
+#endif
+
+// Distance estimate at the fragment.
+float fragment_DE()
 {
-	return colour (DE (position), complex_plane.hit_distance, f_globals.time);
+#ifdef DEEP_ZOOM
+	if (deep_zoom_enabled())
+	{
+		return deep_zoom_DE (f_view_position);
+	}
+#endif
+#ifdef DOUBLE_FLOAT
+	if (f_double_float != 0)
+	{
+		df64_one = float (f_double_float);
+		return double_float_DE (complex_addition_df64 (
+			vec4 (camera.position, camera.position_low),
+			vec4 (f_position, 0.0f, 0.0f)));
+	}
+#endif
+	return DE (f_position + camera.position);
 }
 
+vec3 shade()
+{
+	return colour (fragment_DE(), complex_plane.hit_distance, f_globals.time);
+}
+
+#if defined (G_BUFFER)
+void main()
+{
+	float distance = fragment_DE();
+	g_buffer       = vec4 (
+		smooth_iterations(),
+		get_step(),
+		distance,
+		float (get_iterations()));
+}
+#elif defined (DEFERRED_SHADING)
+// Recolouring only reads the palette, however many iterations the pixels
+//  took.
+void main()
+{
+	highp vec4 pixel = texelFetch (g_buffer_0, ivec2 (gl_FragCoord.xy), 0);
+	fragment_colour  = vec4 (abs (palette (pixel.x, f_globals.time)), 1.0f);
+	fragment_cost    = vec2 (pixel.w, float (get_max_iterations()));
+}
+#else
 void main()
 {
-	vec3 colour     = shade (f_position + camera.position);
+	vec3 colour     = shade();
 	fragment_colour = vec4 (abs (colour), 1.0f);
+	fragment_cost
+		= vec2 (float (get_iterations()), float (get_max_iterations()));
 }
+#endif
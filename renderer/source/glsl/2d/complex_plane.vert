@@ -1,6 +1,10 @@
 #include "structures.glsl"
 #include "constants.glsl"
 
+// Zooming runs out of mediump long before it runs out of float.
+precision highp float;
+precision highp int;
+
 uniform Vertex_Globals v_globals;
 uniform Camera_2d camera;
 
@@ -8,6 +12,14 @@ layout (location = 0) in vec2 v_position;
 
 out vec2 f_position;
 
+// Position in half widths of the view from its centre, for deep zooms
+//  whose scale is past float.
+out vec2 f_view_position;
+
+// Set once the pixels are smaller than float steps at the camera position,
+//  fractals which can then iterate in double-float.
+flat out int f_double_float;
+
 void main()
 {
 	float aspect = float (v_globals.resolution.y)
@@ -16,9 +28,20 @@ void main()
 	float zoom		   = clamp (camera.zoom * -1.0f + 1.0f, min_zoom, 2.0f);
 	float frame_width  = max (screen_width * zoom, min_zoom);
 
-	float width  = v_position.x * frame_width;
-	float height = v_position.y * frame_width * aspect;
+	// Tiles of a larger frame only cover part of the screen quad.
+	vec2 frame_position = v_position * v_globals.tile_scale
+						  + v_globals.tile_offset;
+
+	float width  = frame_position.x * frame_width;
+	float height = frame_position.y * frame_width * aspect;
 	f_position   = vec2 (width, height);
 
+	f_view_position = vec2 (frame_position.x, frame_position.y * aspect);
+
+	// The same bound as the tile cache, which stops at float precision.
+	float pixel  = 2.0f * frame_width / float (v_globals.resolution.x);
+	float extent = max (abs (camera.position.x), abs (camera.position.y));
+	f_double_float = extent * float_epsilon > 0.25f * pixel ? 1 : 0;
+
 	gl_Position = vec4 (v_position, 0, 1);
 }
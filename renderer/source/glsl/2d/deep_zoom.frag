@@ -0,0 +1,123 @@
+#requires_implementation
+#include "structures.glsl"
+#include "utility.frag"
+
+// Written by the renderer while deep zooming. Offsets from the reference
+//  point are a float mantissa times a power of two, so that they stay exact
+//  far below the smallest float. The fragment at f_view_position lies
+//  (f_view_position * half_width + view_offset) * 2^exponent from the
+//  reference, whose orbit the reference_orbit texture holds row by row.
+struct Deep_Zoom
+{
+	bool  enabled      = false;
+	vec2  view_offset  = (0.0f, 0.0f);
+	float half_width   = 1.0f;
+	int   exponent     = 0;
+	int   orbit_length = 0;
+};
+
+uniform Deep_Zoom deep_zoom;
+uniform sampler2D reference_orbit;
+
+bool deep_zoom_enabled()
+{
+	return deep_zoom.enabled;
+}
+
+vec2 reference (int iteration)
+{
+	int columns = textureSize (reference_orbit, 0).x;
+	return texelFetch (reference_orbit, ivec2 (iteration % columns, iteration / columns), 0).rg;
+}
+
+// Keeps the mantissa near one, so that squaring it neither overflows nor
+//  underflows before the offset matters. Returns whether it moved.
+bool rescale (inout vec2 mantissa, inout int exponent)
+{
+	float largest = max (abs (mantissa.x), abs (mantissa.y));
+	if (largest == 0.0f || (largest < 65536.0f && largest > 1.0f / 65536.0f))
+	{
+		return false;
+	}
+
+	int shift = int (floor (log2 (largest)));
+	mantissa *= exp2 (float (-shift));
+	exponent += shift;
+	return true;
+}
+
+// Iterates z^2 + c as the reference orbit plus the offset of the fragment,
+//  the Mandelbrot set offsets c and Julia sets the first z. Fragments whose
+//  orbit comes closer to zero than its offset, where the offset would lose
+//  its precision, or which outlive the reference rebase onto the start of
+//  the reference orbit. Returns the iterations, the last step and the
+//  distance estimate, which is zero inside the set and underflows to zero
+//  once the pixels are smaller than a float.
+uint perturbed_orbit (vec2 view_position, bool mandelbrot, uint max_iterations, out vec2 last_step, out float distance)
+{
+	vec2 pixel          = view_position * deep_zoom.half_width + deep_zoom.view_offset;
+	int  pixel_exponent = deep_zoom.exponent;
+
+	// The offset from the reference and the derivative of the orbit by the
+	//  view position, each as mantissa and exponent.
+	vec2 offset              = mandelbrot ? vec2 (0.0f) : pixel;
+	int  offset_exponent     = pixel_exponent;
+	vec2 derivative          = mandelbrot ? vec2 (0.0f) : vec2 (deep_zoom.half_width, 0.0f);
+	int  derivative_exponent = pixel_exponent;
+
+	float offset_scale    = exp2 (float (offset_exponent));
+	float pixel_scale     = mandelbrot ? 1.0f : 0.0f;
+	float derivative_step = mandelbrot ? deep_zoom.half_width : 0.0f;
+
+	int  n    = 0;
+	vec2 z    = reference (0);
+	vec2 step = z + offset * offset_scale;
+
+	uint iterations;
+	for (iterations = 0u; iterations < max_iterations; ++iterations)
+	{
+		derivative = 2.0f * complex_multiplication (step, derivative) + vec2 (derivative_step, 0.0f);
+		offset     = 2.0f * complex_multiplication (z, offset)
+					 + offset_scale * complex_multiplication (offset, offset)
+					 + pixel * pixel_scale;
+
+		++n;
+		z    = reference (n);
+		step = z + offset * offset_scale;
+		if (dot (step, step) > 5.0f)
+			break;
+
+		vec2 full_offset = offset * offset_scale;
+		bool rebase      = dot (step, step) < dot (full_offset, full_offset)
+						   || n + 1 >= deep_zoom.orbit_length;
+		if (rebase)
+		{
+			n               = 0;
+			z               = reference (0);
+			offset          = step - z;
+			offset_exponent = 0;
+		}
+		if (rescale (offset, offset_exponent) || rebase)
+		{
+			offset_scale = exp2 (float (offset_exponent));
+			pixel_scale  = mandelbrot ? exp2 (float (pixel_exponent - offset_exponent)) : 0.0f;
+		}
+		if (rescale (derivative, derivative_exponent))
+		{
+			derivative_step = mandelbrot ? deep_zoom.half_width * exp2 (float (pixel_exponent - derivative_exponent)) : 0.0f;
+		}
+	}
+
+	last_step = step;
+	distance  = 0.0f;
+	if (iterations == max_iterations)
+		return iterations;
+
+	// The derivative by c is the derivative by the view position divided by
+	//  half_width * 2^exponent.
+	float r  = length (step);
+	float dr = length (derivative);
+	distance = 0.5f * r * log (r) / dr * deep_zoom.half_width
+			   * exp2 (float (pixel_exponent - derivative_exponent));
+	return iterations;
+}
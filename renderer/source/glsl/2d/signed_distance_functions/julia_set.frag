@@ -1,11 +1,17 @@
+#deep_zoom
+#double_float
 #include "2d/complex_plane.frag"
+#include "2d/deep_zoom.frag"
 #include "structures.glsl"
 #include "utility.frag"
 
+// The periodicity check stops the orbits which fall into a cycle, which
+//  otherwise run every iteration.
 struct Julia_Set
 {
-	uint iterations = 1000;
-	vec2 constant   = (0.0f, 0.0f);
+	uint iterations        = 1000;
+	vec2 constant          = (0.0f, 0.0f);
+	bool periodicity_check = true;
 };
 
 uniform Julia_Set julia_set;
@@ -17,6 +23,7 @@ float DE (vec2 position)
 {
 	step        = position;
 	vec2 d_step = vec2 (1.0f, 0.0f);
+	vec2 saved  = position;
 
 	for (iterations = 0u; iterations < julia_set.iterations; ++iterations)
 	{
@@ -24,6 +31,11 @@ float DE (vec2 position)
 		step   = complex_multiplication (step, step) + julia_set.constant;
 		if (dot (step, step) > 5.0f)
 			break;
+		if (julia_set.periodicity_check && periodic (step, iterations, saved))
+		{
+			step = vec2 (0.0f, 0.0f);
+			return 0.0f;
+		}
 	}
 	if (iterations == julia_set.iterations)
 		return 0.0f;
@@ -34,6 +46,35 @@ float DE (vec2 position)
 	return 0.5f * r * log (r) / dr;
 }
 
+float double_float_DE (vec4 position)
+{
+	vec4 z      = position;
+	vec2 d_step = vec2 (1.0f, 0.0f);
+
+	for (iterations = 0u; iterations < julia_set.iterations; ++iterations)
+	{
+		d_step = 2.0f * complex_multiplication (z.xy, d_step);
+		z      = complex_addition_df64 (complex_multiplication_df64 (z, z), vec4 (julia_set.constant, 0.0f, 0.0f));
+		if (escaped_df64 (z, 5.0f))
+			break;
+	}
+	step = z.xy;
+	if (iterations == julia_set.iterations)
+		return 0.0f;
+
+	float r  = length (step);
+	float dr = length (d_step);
+
+	return 0.5f * r * log (r) / dr;
+}
+
+float deep_zoom_DE (vec2 view_position)
+{
+	float distance;
+	iterations = perturbed_orbit (view_position, false, julia_set.iterations, step, distance);
+	return distance;
+}
+
 uint get_iterations()
 {
 	return iterations;
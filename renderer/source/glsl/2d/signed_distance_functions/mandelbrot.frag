@@ -1,10 +1,18 @@
+#deep_zoom
+#double_float
 #include "2d/complex_plane.frag"
+#include "2d/deep_zoom.frag"
 #include "structures.glsl"
 #include "utility.frag"
 
+// Interior points otherwise run every iteration. The bulb check finds the
+//  main cardioid and the period 2 bulb before iterating, the periodicity
+//  check the orbits which fall into a cycle.
 struct Mandelbroth
 {
-	uint iterations = 1000;
+	uint iterations        = 1000;
+	bool bulb_check        = true;
+	bool periodicity_check = true;
 };
 
 uniform Mandelbroth mandelbroth;
@@ -12,17 +20,37 @@ uniform Mandelbroth mandelbroth;
 uint iterations;
 vec2 step;
 
+bool in_main_bulbs (vec2 c)
+{
+	float x = c.x - 0.25f;
+	float q = x * x + c.y * c.y;
+	float y = c.x + 1.0f;
+	return q * (q + x) <= 0.25f * c.y * c.y || y * y + c.y * c.y <= 0.0625f;
+}
+
 float DE (vec2 position)
 {
 	step        = vec2 (0.0f, 0.0f);
 	vec2 d_step = vec2 (1.0f, 0.0f);
+	vec2 saved  = vec2 (0.0f, 0.0f);
 
-	for (iterations = 0u; iterations < mandelbroth.iterations; ++iterations)
+	// Interior points keep the iterations they ran, so that the cost shows
+	//  what the checks saved, and colour as if they had not escaped.
+	iterations = 0u;
+	if (mandelbroth.bulb_check && in_main_bulbs (position))
+		return 0.0f;
+
+	for (; iterations < mandelbroth.iterations; ++iterations)
 	{
 		d_step = 2.0f * complex_multiplication (step, d_step) + 1.0;
 		step   = complex_multiplication (step, step) + position;
 		if (dot (step, step) > 5.0f)
 			break;
+		if (mandelbroth.periodicity_check && periodic (step, iterations, saved))
+		{
+			step = vec2 (0.0f, 0.0f);
+			return 0.0f;
+		}
 	}
 	if (iterations == mandelbroth.iterations)
 		return 0.0f;
@@ -33,6 +61,35 @@ float DE (vec2 position)
 	return 0.5f * r * log (r) / dr;
 }
 
+float double_float_DE (vec4 position)
+{
+	vec4 z      = vec4 (0.0f);
+	vec2 d_step = vec2 (1.0f, 0.0f);
+
+	for (iterations = 0u; iterations < mandelbroth.iterations; ++iterations)
+	{
+		d_step = 2.0f * complex_multiplication (z.xy, d_step) + 1.0;
+		z      = complex_addition_df64 (complex_multiplication_df64 (z, z), position);
+		if (escaped_df64 (z, 5.0f))
+			break;
+	}
+	step = z.xy;
+	if (iterations == mandelbroth.iterations)
+		return 0.0f;
+
+	float r  = length (step);
+	float dr = length (d_step);
+
+	return 0.5f * r * log (r) / dr;
+}
+
+float deep_zoom_DE (vec2 view_position)
+{
+	float distance;
+	iterations = perturbed_orbit (view_position, true, mandelbroth.iterations, step, distance);
+	return distance;
+}
+
 uint get_iterations()
 {
 	return iterations;
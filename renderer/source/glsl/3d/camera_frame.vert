@@ -8,6 +8,11 @@ layout (location = 0) in vec2 v_position;
 
 out vec3 f_ray_position;
 out vec3 f_ray_direction;
+out vec2 f_texture_position;
+
+// Tangent of half the angle a pixel covers, the radius of its cone at a unit
+//  distance.
+out float f_pixel_spread;
 
 void main()
 {
@@ -26,12 +31,18 @@ void main()
 	vec3 right = normalize (cross (vec3(0.0f, 1.0f, 0.0f), forward));
 	vec3 up	   = normalize (cross (forward, right));
 
+	// Tiles of a larger frame only cover part of the screen quad.
+	vec2 frame_position = v_position * v_globals.tile_scale
+						  + v_globals.tile_offset;
+
 	f_ray_direction =
 		forward
-		+ width * v_position.x * right
-		+ width * aspect * v_position.y * up;
+		+ width * frame_position.x * right
+		+ width * aspect * frame_position.y * up;
 
-	f_ray_position  = camera.position;
+	f_ray_position     = camera.position;
+	f_texture_position = v_position * 0.5f + 0.5f;
+	f_pixel_spread     = width / float (v_globals.resolution.x);
 
 	gl_Position = vec4 (v_position, 0.0f, 1.0f);
 }
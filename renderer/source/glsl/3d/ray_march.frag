@@ -4,11 +4,24 @@
 #include "structures.glsl"
 #include "3d/utility_3d.frag"
 
+// Relaxation steps further than the distance estimate by its factor, taking
+//  back the step whenever it overshot. One is plain sphere tracing, 1.2 to
+//  1.6 saves steps along surfaces which the rays graze. Tetrahedral normals
+//  take four distance estimates instead of six, unless the distance
+//  estimator has an analytic gradient. Rays further than the far distance
+//  from where they started or last reflected count as misses. Rays hit once
+//  they come closer than the pixel footprint times the radius of the pixel's
+//  cone, which grows with the distance from the camera, or than the fixed
+//  hit distance when the footprint is zero.
 struct Ray_Marcher
 {
-	uint  max_steps	   = 50;
-	uint  max_ray_hits = 2;
-	float hit_distance = 0.01f;
+	uint  max_steps           = 50;
+	uint  max_ray_hits        = 2;
+	float hit_distance        = 0.01f;
+	float pixel_footprint     = 1.0f;
+	float relaxation          = 1.0f;
+	bool  tetrahedral_normals = false;
+	float far_distance        = 100.0f;
 };
 
 struct Material
@@ -21,48 +34,286 @@ uniform Camera_3d		 camera;
 uniform Ray_Marcher		 ray_marcher;
 uniform Material		 material;
 
+// Distance each ray can skip and the steps a plain march takes to get there,
+//  written by the renderer's cone prepass. Without it every texel is zero.
+precision highp sampler2D;
+uniform sampler2D ray_start;
+
 in vec3 f_ray_position;
 in vec3 f_ray_direction;
+in vec2 f_texture_position;
+in float f_pixel_spread;
+
+#ifdef G_BUFFER
+// Position and steps, normal and closest distance of the first two hits of
+//  each ray. Hits the ray never made have a zero normal and the steps of the
+//  whole march.
+layout (location = 0) out vec4 g_buffer[4];
+
+const uint g_buffer_hits = 2u;
+vec4       hit_positions[2];
+vec4       hit_normals[2];
+
+// Constant indices keep the hits in registers.
+void record_hit (uint hit, vec4 position, vec4 normal)
+{
+	if (hit == 0u)
+	{
+		hit_positions[0] = position;
+		hit_normals[0]   = normal;
+	}
+	else
+	{
+		hit_positions[1] = position;
+		hit_normals[1]   = normal;
+	}
+}
+#else
+layout (location = 0) out vec4 fragment_colour;
+
+// Steps taken and the step budget, for the cost overlay. The output is
+//  dropped unless a second colour attachment is bound.
+layout (location = 1) out vec2 fragment_cost;
+#endif
+
+#ifdef DEFERRED_SHADING
+// The G-buffer written by the G_BUFFER variant, bound by the renderer.
+uniform sampler2D g_buffer_0;
+uniform sampler2D g_buffer_1;
+uniform sampler2D g_buffer_2;
+uniform sampler2D g_buffer_3;
+#endif
+
+uint steps;
+
+// Closer than this to a surface counts as a hit, for a ray which travelled
+//  the distance since leaving the camera.
+float hit_threshold (float distance)
+{
+	if (ray_marcher.pixel_footprint > 0.0f)
+	{
+		return ray_marcher.pixel_footprint * f_pixel_spread * distance;
+	}
+	return ray_marcher.hit_distance;
+}
 
-out vec4 fragment_colour;
+// Colour of a hit, the rest of the light goes on along the reflected ray.
+vec3 shade_hit (inout float colour_multiplier, uint hit_steps, float closest_distance, vec3 direction, vec3 normal)
+{
+	float colour_intensity = colour_multiplier * (1.0f - material.specular_intensity);
+	colour_multiplier -= colour_intensity;
+	return colour_intensity * diffuse_colour (hit_steps, ray_marcher.max_steps, closest_distance, direction, normal);
+}
 
 vec3 march (vec3 origin, vec3 direction)
 {
-	uint  steps            = 0u;
+#ifdef G_BUFFER
+	uint  max_ray_hits     = min (ray_marcher.max_ray_hits, g_buffer_hits);
+#else
+	uint  max_ray_hits     = ray_marcher.max_ray_hits;
+#endif
 	uint  current_ray_hits = 0u;
+	vec2  start            = texture (ray_start, f_texture_position).rg;
 
-	vec3  position         = origin;
+	// Rays which miss the bounds of the distance estimator are not marched,
+	//  the others start where they enter them and stop where they leave.
+	//  The bounds grow by the largest threshold a ray can reach.
+	float margin           = hit_threshold (ray_marcher.far_distance);
+	vec2  bounds           = ray_bounds (origin, direction, margin, ray_marcher.far_distance);
+	float travelled        = max (start.x, bounds.x);
+	float path             = 0.0f;
+	vec3  position         = origin + direction * travelled;
 	float closest_distance = f_globals.world_size;
 
 	vec3  colour			= vec3(0.0f);
 	float colour_multiplier = 1.0f;
 
-	for (steps = 0u; steps < ray_marcher.max_steps && current_ray_hits < ray_marcher.max_ray_hits; ++steps)
+	float relaxation    = ray_marcher.relaxation;
+	float last_distance = 0.0f;
+	float last_step     = 0.0f;
+
+	for (steps = uint (start.y); steps < ray_marcher.max_steps && current_ray_hits < max_ray_hits && travelled < bounds.y; ++steps)
 	{
 		float distance = DE (position);
+
+		// The relaxed step overshot once the spheres around its ends no
+		//  longer overlap. Go back to where a plain step would have ended
+		//  and march plainly until the next hit.
+		if (relaxation > 1.0f && distance + last_distance < last_step)
+		{
+			position   -= direction * (last_step - last_distance);
+			travelled  -= last_step - last_distance;
+			relaxation  = 1.0f;
+			last_step   = 0.0f;
+			continue;
+		}
+
 		closest_distance = min (distance, closest_distance);
-		position         += direction * distance;
+		last_distance    = distance;
+		last_step        = distance * relaxation;
+		position         += direction * last_step;
+		travelled        += last_step;
 
-		if (ray_marcher.hit_distance > distance)
+		float threshold = hit_threshold (path + travelled);
+		if (threshold > distance)
 		{
+			vec3 normal = surface_normal (direction, position, ray_marcher.tetrahedral_normals);
+#ifdef G_BUFFER
+			record_hit (current_ray_hits, vec4 (position, float (steps)), vec4 (normal, closest_distance));
+#else
+			colour += shade_hit (colour_multiplier, steps, closest_distance, direction, normal);
+#endif
 			current_ray_hits += 1u;
+			closest_distance  = f_globals.world_size;
 
-			float colour_intensity = colour_multiplier * (1.0f - material.specular_intensity);
-			colour_multiplier -= colour_intensity;
+			direction = reflect_ray (direction, normal);
+			position += 2.0f * threshold * direction;
 
-			colour += colour_intensity * diffuse_colour (steps, ray_marcher.max_steps, closest_distance, direction, position);
-			closest_distance = f_globals.world_size;
+			relaxation    = ray_marcher.relaxation;
+			last_distance = 0.0f;
+			last_step     = 0.0f;
 
-			direction = reflect_ray(direction, position);
-			position += 2.0f * ray_marcher.hit_distance * direction;
+			path     += travelled;
+			margin    = hit_threshold (path + ray_marcher.far_distance);
+			bounds    = ray_bounds (position, direction, margin, ray_marcher.far_distance);
+			travelled = bounds.x;
+			position += direction * travelled;
 		}
 	}
 
+#ifdef G_BUFFER
+	for (uint hit = current_ray_hits; hit < g_buffer_hits; ++hit)
+	{
+		record_hit (hit, vec4 (vec3 (0.0f), float (steps)), vec4 (0.0f));
+	}
+
+	// Nothing in this pass reads the colouring, so changing it leaves the
+	//  G-buffer as it is.
+	return vec3 (0.0f);
+#else
 	return colour + colour_multiplier * background_colour (direction);
+#endif
+}
+
+#ifdef CONE_PREPASS
+// Steps a plain march along the direction takes from the start to the
+//  distance travelled.
+uint plain_steps (vec3 direction, vec2 start, float travelled)
+{
+	float plain = start.x;
+	uint  count = uint (start.y);
+	for (; count < ray_marcher.max_steps && plain < travelled; ++count)
+	{
+		plain += DE (f_ray_position + direction * plain);
+	}
+	return count;
+}
+
+// Marches the cone through a texel of a lower resolution level, with steps
+//  short enough that the empty sphere around the axis holds the whole cross
+//  section of the cone. Rays of the finer levels inside the texel resume
+//  from the distance reached. They also start from the fewest steps a plain
+//  march along the centre or the corners takes to get there, so that the
+//  colouring and the cost overlay stay close to marching every step, while
+//  rays grazing a surface keep enough of their budget to reach it.
+void main()
+{
+	vec3  direction  = normalize (f_ray_direction);
+	vec3  horizontal = 0.5f * dFdx (f_ray_direction);
+	vec3  vertical   = 0.5f * dFdy (f_ray_direction);
+	vec3  corners[4] = vec3[4] (
+		normalize (f_ray_direction - horizontal - vertical),
+		normalize (f_ray_direction + horizontal - vertical),
+		normalize (f_ray_direction - horizontal + vertical),
+		normalize (f_ray_direction + horizontal + vertical));
+
+	// Tangent of the widest corner, without the cancellation of one minus
+	//  the cosine at small angles.
+	float spread = 0.0f;
+	for (int corner = 0; corner < 4; ++corner)
+	{
+		spread = max (
+			spread,
+			length (cross (direction, corners[corner]))
+				/ dot (direction, corners[corner]));
+	}
+
+	vec2  start     = texture (ray_start, f_texture_position).rg;
+	float travelled = start.x;
+	for (uint i = 0u; i < ray_marcher.max_steps; ++i)
+	{
+		// Rays closer than the hit threshold count as hits, so the sphere
+		//  keeps clear of the surface by that much. A cone wider than the
+		//  world has missed it, its rays are left to finish on their own
+		//  rather than marching on towards overflow.
+		float radius   = travelled * spread;
+		float distance = DE (f_ray_position + direction * travelled)
+						 - hit_threshold (travelled);
+		if (distance <= radius || radius > f_globals.world_size)
+		{
+			break;
+		}
+
+		float cone = 1.0f + spread * spread;
+		travelled += (sqrt (distance * distance * cone - radius * radius)
+					  - radius * spread)
+					 / cone;
+	}
+
+	steps = plain_steps (direction, start, travelled);
+	for (int corner = 0; corner < 4; ++corner)
+	{
+		steps = min (steps, plain_steps (corners[corner], start, travelled));
+	}
+
+	fragment_colour = vec4 (travelled, float (steps), 0.0f, 0.0f);
+}
+#elif defined (G_BUFFER)
+void main()
+{
+	march (f_ray_position, normalize (f_ray_direction));
+	g_buffer[0] = hit_positions[0];
+	g_buffer[1] = hit_normals[0];
+	g_buffer[2] = hit_positions[1];
+	g_buffer[3] = hit_normals[1];
 }
+#elif defined (DEFERRED_SHADING)
+// Colours the hits of the G-buffer the way march does, both passes see the
+//  same pixels so the G-buffer is read at the fragment's own coordinates.
+void main()
+{
+	ivec2 texel        = ivec2 (gl_FragCoord.xy);
+	vec4  positions[2] = vec4[2] (
+		texelFetch (g_buffer_0, texel, 0),
+		texelFetch (g_buffer_2, texel, 0));
+	vec4  normals[2]   = vec4[2] (
+		texelFetch (g_buffer_1, texel, 0),
+		texelFetch (g_buffer_3, texel, 0));
+
+	vec3  direction         = normalize (f_ray_direction);
+	vec3  colour            = vec3 (0.0f);
+	float colour_multiplier = 1.0f;
+	for (int hit = 0; hit < 2; ++hit)
+	{
+		steps = uint (positions[hit].w);
+		if (normals[hit].xyz == vec3 (0.0f))
+		{
+			break;
+		}
 
+		colour += shade_hit (colour_multiplier, steps, normals[hit].w, direction, normals[hit].xyz);
+		direction = reflect_ray (direction, normals[hit].xyz);
+	}
+
+	colour         += colour_multiplier * background_colour (direction);
+	fragment_colour = vec4 (abs (colour), 1.0f);
+	fragment_cost   = vec2 (float (steps), float (ray_marcher.max_steps));
+}
+#else
 void main()
 {
 	vec3 colour     = march (f_ray_position, normalize (f_ray_direction));
 	fragment_colour = vec4 (abs (colour), 1.0f);
+	fragment_cost   = vec2 (float (steps), float (ray_marcher.max_steps));
 }
+#endif
@@ -1,3 +1,4 @@
+#bounding_sphere
 #include "3d/colouring.frag"
 #include "3d/ray_march.frag"
 
@@ -28,4 +29,8 @@ float DE (vec3 position)
 				   + project (up, plane.height, relative);
 
 	return length (relative - closest);
-}
\ No newline at end of file
+}
+vec4 bounding_sphere()
+{
+	return vec4 (plane.position, length (vec2 (plane.width, plane.height)));
+}
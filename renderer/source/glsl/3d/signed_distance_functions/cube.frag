@@ -1,3 +1,4 @@
+#bounding_sphere
 #include "3d/colouring.frag"
 #include "3d/ray_march.frag"
 
@@ -30,3 +31,8 @@ float DE (vec3 position)
 	vec3 offset     = projection - cube.size;
 	return length (max (offset, 0.0f));
 }
+
+vec4 bounding_sphere()
+{
+	return vec4 (cube.origin, length (cube.size));
+}
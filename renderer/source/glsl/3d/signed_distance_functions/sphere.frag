@@ -1,3 +1,5 @@
+#analytic_gradient
+#bounding_sphere
 #include "3d/colouring.frag"
 #include "3d/ray_march.frag"
 
@@ -13,3 +15,14 @@ float DE (vec3 position)
 {
 	return abs (length (position - sphere.origin) - sphere.radius);
 }
+
+vec3 gradient (vec3 position)
+{
+	vec3 relative = position - sphere.origin;
+	return relative * sign (length (relative) - sphere.radius);
+}
+
+vec4 bounding_sphere()
+{
+	return vec4 (sphere.origin, sphere.radius);
+}
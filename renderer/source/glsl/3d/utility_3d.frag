@@ -1,7 +1,61 @@
 #requires_implementation
 
 float DE (vec3 position);
-vec3  normal_estimator (vec3 direction, vec3 position, float distance)
+
+#ifdef ANALYTIC_GRADIENT
+// Implemented by distance estimators which declare an analytic gradient,
+//  giving the normal without sampling around the position.
+vec3 gradient (vec3 position);
+#endif
+
+// Bounds declared by the distance estimator, nothing outside of them is
+//  closer than the hit distance to a surface once grown by it.
+#ifdef BOUNDING_SPHERE
+vec4 bounding_sphere();
+#endif
+#ifdef BOUNDING_BOX
+void bounding_box (out vec3 minimum, out vec3 maximum);
+#endif
+
+// Distances along the ray at which it enters and leaves the bounds grown by
+//  the margin, no further than the far distance. The entry lies past the
+//  exit for rays which miss them.
+vec2 ray_bounds (vec3 origin, vec3 direction, float margin, float far)
+{
+	vec2 bounds = vec2 (0.0f, far);
+#ifdef BOUNDING_SPHERE
+	vec4  sphere       = bounding_sphere();
+	vec3  relative     = origin - sphere.xyz;
+	float radius       = sphere.w + margin;
+	float middle       = -dot (relative, direction);
+	float discriminant = middle * middle - dot (relative, relative)
+						 + radius * radius;
+	if (discriminant < 0.0f)
+	{
+		return vec2 (1.0f, 0.0f);
+	}
+	float half_chord = sqrt (discriminant);
+	bounds = vec2 (max (bounds.x, middle - half_chord),
+				   min (bounds.y, middle + half_chord));
+#endif
+#ifdef BOUNDING_BOX
+	vec3 minimum;
+	vec3 maximum;
+	bounding_box (minimum, maximum);
+
+	vec3 inverse = 1.0f / direction;
+	vec3 lower   = (minimum - margin - origin) * inverse;
+	vec3 upper   = (maximum + margin - origin) * inverse;
+	vec3 entry   = min (lower, upper);
+	vec3 exit    = max (lower, upper);
+	bounds = vec2 (max (bounds.x, max (entry.x, max (entry.y, entry.z))),
+				   min (bounds.y, min (exit.x, min (exit.y, exit.z))));
+#endif
+	return bounds;
+}
+
+// Central differences, six evaluations of the distance estimator.
+vec3 normal_estimator (vec3 direction, vec3 position, float distance)
 {
 	vec3 offset = vec3 (distance * 0.5, 0.0, 0.0);
 	position -= direction * distance * 0.5f;
@@ -11,9 +65,34 @@ vec3  normal_estimator (vec3 direction, vec3 position, float distance)
 		DE (position + offset.yyx) - DE (position - offset.yyx)));
 }
 
-vec3 reflect_ray (vec3 direction, vec3 position)
+// Tetrahedral differences, four evaluations of the distance estimator.
+vec3 tetrahedral_normal_estimator (vec3 direction, vec3 position, float distance)
+{
+	vec2 offset = vec2 (1.0f, -1.0f) * distance * 0.5f;
+	position -= direction * distance * 0.5f;
+	return normalize (
+		offset.xyy * DE (position + offset.xyy)
+		+ offset.yyx * DE (position + offset.yyx)
+		+ offset.yxy * DE (position + offset.yxy)
+		+ offset.xxx * DE (position + offset.xxx));
+}
+
+// The normal at a hit, computed once for both shading and reflection.
+vec3 surface_normal (vec3 direction, vec3 position, bool tetrahedral)
+{
+#ifdef ANALYTIC_GRADIENT
+	return normalize (gradient (position));
+#else
+	if (tetrahedral)
+	{
+		return tetrahedral_normal_estimator (direction, position, 1e-06);
+	}
+	return normal_estimator (direction, position, 1e-06);
+#endif
+}
+
+vec3 reflect_ray (vec3 direction, vec3 normal)
 {
-	vec3 normal = normal_estimator (direction, position, 1e-06);
 	vec3 parallel_to_normal = dot (-direction, normal) * normal;
 	return direction + 2.0f * parallel_to_normal;
 }
@@ -1,5 +1,7 @@
 const float pi = 3.141592653589793116f;
 const float pi_2 = 1.570796326794896558f;
 
+const float float_epsilon = 1.1920928955078125e-7f;
+
 const float min_zoom = 1e-6f;
 const float screen_in_pixels_2d = 512.0f;
@@ -0,0 +1,39 @@
+#vertex_shader "debug/screen.vert"
+
+#include "structures.glsl"
+
+struct Cost_Overlay
+{
+	float opacity = 0.6f;
+};
+
+uniform Cost_Overlay cost_overlay;
+uniform sampler2D    frame_colour;
+uniform sampler2D    frame_cost;
+
+in vec2 f_texture_position;
+
+out vec4 fragment_colour;
+
+// Blue for cheap pixels through green and yellow to red for pixels which
+//  used their whole budget.
+vec3 heat (float cost)
+{
+	return clamp (
+		vec3 (
+			min (4.0f * cost - 1.5f, 4.5f - 4.0f * cost),
+			min (4.0f * cost - 0.5f, 3.5f - 4.0f * cost),
+			min (4.0f * cost + 0.5f, 2.5f - 4.0f * cost)),
+		0.0f,
+		1.0f);
+}
+
+void main()
+{
+	vec3  colour = texture (frame_colour, f_texture_position).rgb;
+	vec2  cost   = texture (frame_cost, f_texture_position).rg;
+	float used   = cost.y > 0.0f ? cost.x / cost.y : 0.0f;
+
+	fragment_colour
+		= vec4 (mix (colour, heat (used), cost_overlay.opacity), 1.0f);
+}
@@ -0,0 +1,11 @@
+#include "structures.glsl"
+
+layout (location = 0) in vec2 v_position;
+
+out vec2 f_texture_position;
+
+void main()
+{
+	f_texture_position = v_position * 0.5f + 0.5f;
+	gl_Position        = vec4 (v_position, 0, 1);
+}
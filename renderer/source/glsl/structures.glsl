@@ -4,6 +4,8 @@ precision mediump float;
 struct Vertex_Globals
 {
 	uvec2 resolution;
+	vec2  tile_offset = (0.0f, 0.0f);
+	vec2  tile_scale  = (1.0f, 1.0f);
 };
 
 struct Fragment_Globals
@@ -25,8 +27,9 @@ struct Camera_3d
 
 struct Camera_2d
 {
-	vec2  position = (0.0f, 0.0f);
-	float zoom     = 0.0f;
+	vec2  position     = (0.0f, 0.0f);
+	vec2  position_low = (0.0f, 0.0f);
+	float zoom         = 0.0f;
 };
 
 struct Colouring
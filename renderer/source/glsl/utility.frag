@@ -9,3 +9,103 @@ float random (vec2 co)
 {
 	return fract (sin (dot (co.xy, vec2 (12.9898, 78.233))) * 43758.5453);
 }
+
+// Brent's cycle detection for escape-time fractals. The orbit is compared
+//  to the point saved at the last power of two iterations, an orbit which
+//  returns to it has fallen into an attracting cycle and never escapes.
+bool periodic (vec2 z, uint iteration, inout vec2 saved)
+{
+	vec2 difference = z - saved;
+	if (dot (difference, difference) < 1e-12f)
+		return true;
+
+	if ((iteration & (iteration + 1u)) == 0u)
+		saved = z;
+	return false;
+}
+
+// Double-float arithmetic, for zooms past float precision on GPUs without
+//  fast doubles. A value is the unevaluated sum of a high and a low float,
+//  which together hold about 48 bits. Complex values keep both high parts
+//  in xy and both low parts in zw, so that xy alone is the float value.
+
+// One, set by the caller at run time. Compilers may treat float arithmetic
+//  as associative, which folds the rounding errors below to zero, so each
+//  rounding they depend on is kept by a product with this unknown value.
+float df64_one = 0.0f;
+
+float df64_rounded (float value)
+{
+	return value * df64_one;
+}
+
+// The sum of a and b and its rounding error.
+vec2 df64_two_sum (float a, float b)
+{
+	float sum    = df64_rounded (a + b);
+	float b_part = df64_rounded (sum - a);
+	float a_part = df64_rounded (sum - b_part);
+	return vec2 (sum, df64_rounded (a - a_part) + df64_rounded (b - b_part));
+}
+
+// As df64_two_sum, for |a| >= |b|.
+vec2 df64_quick_two_sum (float a, float b)
+{
+	float sum = df64_rounded (a + b);
+	return vec2 (sum, b - df64_rounded (sum - a));
+}
+
+// The product of a and b and its rounding error, from halves of 12 bits
+//  whose products are exact.
+vec2 df64_two_product (float a, float b)
+{
+	const float split = 4097.0f;
+
+	float a_split = df64_rounded (a * split);
+	float a_high  = df64_rounded (a_split - df64_rounded (a_split - a));
+	float a_low   = a - a_high;
+	float b_split = df64_rounded (b * split);
+	float b_high  = df64_rounded (b_split - df64_rounded (b_split - b));
+	float b_low   = b - b_high;
+
+	float product = df64_rounded (a * b);
+	float error   = df64_rounded (a_high * b_high - product);
+	error         = df64_rounded (error + a_high * b_low);
+	error         = df64_rounded (error + a_low * b_high);
+	return vec2 (product, error + a_low * b_low);
+}
+
+vec2 df64_add (vec2 a, vec2 b)
+{
+	vec2 sum = df64_two_sum (a.x, b.x);
+	return df64_quick_two_sum (sum.x, sum.y + a.y + b.y);
+}
+
+vec2 df64_multiply (vec2 a, vec2 b)
+{
+	vec2 product = df64_two_product (a.x, b.x);
+	return df64_quick_two_sum (
+		product.x,
+		product.y + a.x * b.y + a.y * b.x);
+}
+
+vec4 complex_addition_df64 (vec4 a, vec4 b)
+{
+	vec2 real      = df64_add (a.xz, b.xz);
+	vec2 imaginary = df64_add (a.yw, b.yw);
+	return vec4 (real.x, imaginary.x, real.y, imaginary.y);
+}
+
+vec4 complex_multiplication_df64 (vec4 a, vec4 b)
+{
+	vec2 real = df64_add (df64_multiply (a.xz, b.xz), -df64_multiply (a.yw, b.yw));
+	vec2 imaginary = df64_add (df64_multiply (a.xz, b.yw), df64_multiply (a.yw, b.xz));
+	return vec4 (real.x, imaginary.x, real.y, imaginary.y);
+}
+
+// The low parts can not move a value across an escape radius of a few
+//  units, so the test only reads the high parts.
+bool escaped_df64 (vec4 z, float squared_radius)
+{
+	return dot (z.xy, z.xy) > squared_radius;
+}
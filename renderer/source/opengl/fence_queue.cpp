@@ -0,0 +1,59 @@
+#include "fence_queue.hpp"
+
+#include <iostream>
+
+namespace renderer::gl
+{
+
+Fence_Queue::~Fence_Queue()
+{
+	for (Fence const& fence : fences)
+	{
+		glDeleteSync (fence.sync);
+	}
+}
+
+void Fence_Queue::push (Callback callback)
+{
+	// Flushing submits the fence, otherwise polling without waiting might
+	//  never see it signal.
+	fences.push_back (
+		{glFenceSync (GL_SYNC_GPU_COMMANDS_COMPLETE, 0), std::move (callback)});
+	glFlush();
+}
+
+void Fence_Queue::poll (bool wait)
+{
+	const GLuint64 timeout = wait ? GL_TIMEOUT_IGNORED : 0;
+	while (!fences.empty())
+	{
+		Fence&       fence  = fences.front();
+		const GLenum status = glClientWaitSync (
+			fence.sync,
+			GL_SYNC_FLUSH_COMMANDS_BIT,
+			timeout);
+		if (status == GL_TIMEOUT_EXPIRED)
+		{
+			return;
+		}
+
+		const auto signalled = std::chrono::steady_clock::now();
+		glDeleteSync (fence.sync);
+		Callback callback = std::move (fence.callback);
+		fences.pop_front();
+
+		if (status == GL_WAIT_FAILED)
+		{
+			std::cerr << "Waiting for a fence failed.\n";
+			continue;
+		}
+		callback (signalled);
+	}
+}
+
+bool Fence_Queue::is_pending() const
+{
+	return !fences.empty();
+}
+
+} // namespace renderer::gl
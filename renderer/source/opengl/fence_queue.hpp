@@ -0,0 +1,45 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include <chrono>
+#include <deque>
+#include <functional>
+
+namespace renderer::gl
+{
+
+// Calls back once the GPU has finished every command submitted before the
+//  callback was queued. Fences are checked in submission order without
+//  waiting unless asked to, so a completion is seen on the first poll after
+//  it happened.
+class Fence_Queue
+{
+public:
+	using Callback
+		= std::function<void (std::chrono::steady_clock::time_point)>;
+
+	Fence_Queue() = default;
+	~Fence_Queue();
+
+	Fence_Queue (Fence_Queue const&) = delete;
+	Fence_Queue& operator= (Fence_Queue const&) = delete;
+
+	void push (Callback callback);
+
+	// The callback receives the time its fence was found signalled.
+	void poll (bool wait = false);
+
+	bool is_pending() const;
+
+private:
+	struct Fence
+	{
+		GLsync   sync;
+		Callback callback;
+	};
+
+	std::deque<Fence> fences;
+};
+
+} // namespace renderer::gl
@@ -0,0 +1,132 @@
+#include "framebuffer.hpp"
+
+#include <iostream>
+
+namespace
+{
+
+GLenum pixel_format (GLenum internal_format)
+{
+	switch (internal_format)
+	{
+	case GL_R32F:
+	case GL_R16F:  return GL_RED;
+	case GL_RG32F:
+	case GL_RG16F: return GL_RG;
+	default:       return GL_RGBA;
+	}
+}
+
+GLenum pixel_type (GLenum internal_format)
+{
+	switch (internal_format)
+	{
+	case GL_RGBA8: return GL_UNSIGNED_BYTE;
+	default:       return GL_FLOAT;
+	}
+}
+
+} // namespace
+
+namespace renderer
+{
+
+Framebuffer::Framebuffer (std::vector<GLenum> const& colour_formats)
+	: formats (colour_formats)
+	, textures (colour_formats.size(), 0)
+{
+	glGenFramebuffers (1, &framebuffer_id);
+	glGenTextures (static_cast<GLsizei> (textures.size()), textures.data());
+}
+
+Framebuffer::~Framebuffer()
+{
+	glDeleteTextures (static_cast<GLsizei> (textures.size()), textures.data());
+	glDeleteFramebuffers (1, &framebuffer_id);
+}
+
+void Framebuffer::resize (unsigned int p_width, unsigned int p_height)
+{
+	if (p_width == width && p_height == height)
+	{
+		return;
+	}
+
+	width  = p_width;
+	height = p_height;
+
+	GLint previous_framebuffer = 0;
+	glGetIntegerv (GL_DRAW_FRAMEBUFFER_BINDING, &previous_framebuffer);
+	glBindFramebuffer (GL_FRAMEBUFFER, framebuffer_id);
+
+	std::vector<GLenum> draw_buffers;
+	for (size_t i = 0; i < textures.size(); ++i)
+	{
+		glBindTexture (GL_TEXTURE_2D, textures[i]);
+		glTexImage2D (
+			GL_TEXTURE_2D,
+			0,
+			static_cast<GLint> (formats[i]),
+			static_cast<GLsizei> (width),
+			static_cast<GLsizei> (height),
+			0,
+			pixel_format (formats[i]),
+			pixel_type (formats[i]),
+			nullptr);
+		glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		const GLenum attachment
+			= GL_COLOR_ATTACHMENT0 + static_cast<GLenum> (i);
+		glFramebufferTexture2D (
+			GL_FRAMEBUFFER,
+			attachment,
+			GL_TEXTURE_2D,
+			textures[i],
+			0);
+		draw_buffers.push_back (attachment);
+	}
+	glBindTexture (GL_TEXTURE_2D, 0);
+	glDrawBuffers (
+		static_cast<GLsizei> (draw_buffers.size()),
+		draw_buffers.data());
+
+	if (glCheckFramebufferStatus (GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		std::cerr << "Offscreen framebuffer of size " << width << "x" << height
+				  << " is incomplete.\n";
+	}
+
+	glBindFramebuffer (
+		GL_FRAMEBUFFER,
+		static_cast<GLuint> (previous_framebuffer));
+}
+
+void Framebuffer::bind() const
+{
+	glBindFramebuffer (GL_FRAMEBUFFER, framebuffer_id);
+}
+
+GLuint Framebuffer::get_id() const
+{
+	return framebuffer_id;
+}
+
+GLuint Framebuffer::get_texture (size_t attachment) const
+{
+	return textures[attachment];
+}
+
+unsigned int Framebuffer::get_width() const
+{
+	return width;
+}
+
+unsigned int Framebuffer::get_height() const
+{
+	return height;
+}
+
+} // namespace renderer
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include <vector>
+
+namespace renderer
+{
+
+// An offscreen render target whose colour attachments are textures so that
+//  later passes can either blit or sample from them.
+class Framebuffer
+{
+public:
+	Framebuffer (std::vector<GLenum> const& colour_formats = {GL_RGBA8});
+	~Framebuffer();
+
+	Framebuffer (Framebuffer const&) = delete;
+	Framebuffer& operator= (Framebuffer const&) = delete;
+
+	// Reallocates the attachments only when the size changes.
+	void resize (unsigned int width, unsigned int height);
+	void bind() const;
+
+	GLuint       get_id() const;
+	GLuint       get_texture (size_t attachment) const;
+	unsigned int get_width() const;
+	unsigned int get_height() const;
+
+private:
+	const std::vector<GLenum> formats;
+
+	GLuint              framebuffer_id = 0;
+	std::vector<GLuint> textures;
+
+	unsigned int width  = 0;
+	unsigned int height = 0;
+};
+
+} // namespace renderer
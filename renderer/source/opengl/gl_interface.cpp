@@ -1,5 +1,7 @@
 #include "gl_interface.hpp"
 
+#include "trace.hpp"
+
 #include <algorithm>
 #include <functional>
 #include <map>
@@ -133,7 +135,20 @@ namespace gl
 
 void init()
 {
-	GLenum status = glewInit();
+	// Core profile contexts need the experimental flag for GLEW to load
+	//  every entry point.
+	glewExperimental = GL_TRUE;
+	GLenum status    = glewInit();
+
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+	// Surfaceless EGL contexts have no GLX display, the entry points are
+	//  loaded regardless.
+	if (status == GLEW_ERROR_NO_GLX_DISPLAY)
+	{
+		status = GLEW_OK;
+	}
+#endif
+
 	if (status != GLEW_OK)
 	{
 		std::cerr << "Error initialising GLEW: " << glewGetErrorString (status)
@@ -173,6 +188,7 @@ std::pair<bool, GLuint> create_program (
 	const std::string& vertex_shader_code,
 	const std::string& fragment_shader_code)
 {
+	TRACE_SCOPE ("gl::create_program");
 	GLuint program_id = glCreateProgram();
 	auto [vertex_success, vertex_shader]
 		= compile_shader (vertex_shader_code, Shader_Type::Vertex);
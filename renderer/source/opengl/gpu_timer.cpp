@@ -0,0 +1,109 @@
+#include "gpu_timer.hpp"
+
+namespace renderer::gl
+{
+
+Gpu_Timer::Gpu_Timer (size_t query_count) : free_queries (query_count, 0)
+{
+	glGenQueries (static_cast<GLsizei> (query_count), free_queries.data());
+}
+
+Gpu_Timer::~Gpu_Timer()
+{
+	for (Query const& query : in_flight)
+	{
+		free_queries.push_back (query.id);
+	}
+	glDeleteQueries (
+		static_cast<GLsizei> (free_queries.size()),
+		free_queries.data());
+}
+
+void Gpu_Timer::begin_pass()
+{
+	if (free_queries.empty())
+	{
+		read_oldest();
+	}
+
+	active = free_queries.back();
+	free_queries.pop_back();
+	glBeginQuery (GL_TIME_ELAPSED, active);
+}
+
+void Gpu_Timer::end_pass (bool frame_complete)
+{
+	glEndQuery (GL_TIME_ELAPSED);
+	in_flight.push_back ({active, frame_complete, false});
+	active = 0;
+}
+
+void Gpu_Timer::discard_frame()
+{
+	if (in_flight.empty())
+	{
+		frame_total   = 0.0;
+		frame_invalid = false;
+	}
+	else if (!in_flight.back().frame_complete)
+	{
+		in_flight.back().frame_discarded = true;
+	}
+}
+
+std::vector<float> Gpu_Timer::collect_frames (bool wait)
+{
+	while (!in_flight.empty())
+	{
+		GLuint available = GL_TRUE;
+		if (!wait)
+		{
+			glGetQueryObjectuiv (
+				in_flight.front().id,
+				GL_QUERY_RESULT_AVAILABLE,
+				&available);
+		}
+		if (available == GL_FALSE)
+		{
+			break;
+		}
+		read_oldest();
+	}
+
+	std::vector<float> frames;
+	frames.swap (finished_frames);
+	return frames;
+}
+
+void Gpu_Timer::read_oldest()
+{
+	// Queries finish in the order they were issued.
+	const Query query = in_flight.front();
+	in_flight.pop_front();
+
+	GLuint64 nanoseconds = 0;
+	glGetQueryObjectui64v (query.id, GL_QUERY_RESULT, &nanoseconds);
+	free_queries.push_back (query.id);
+
+	// Mesa llvmpipe reports the start timestamp for the first query which
+	//  contains work, no pass can take longer than the timer has existed.
+	const std::chrono::nanoseconds lifetime
+		= std::chrono::steady_clock::now() - created;
+	if (nanoseconds > static_cast<GLuint64> (lifetime.count()))
+	{
+		frame_invalid = true;
+	}
+
+	frame_total += static_cast<double> (nanoseconds) / 1.0e6;
+	if (query.frame_complete && !query.frame_discarded && !frame_invalid)
+	{
+		finished_frames.push_back (static_cast<float> (frame_total));
+	}
+	if (query.frame_complete || query.frame_discarded)
+	{
+		frame_total   = 0.0;
+		frame_invalid = false;
+	}
+}
+
+} // namespace renderer::gl
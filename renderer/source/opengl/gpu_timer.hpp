@@ -0,0 +1,60 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include <chrono>
+#include <deque>
+#include <vector>
+
+namespace renderer::gl
+{
+
+// Measures the GPU time of frames with GL_TIME_ELAPSED queries. A frame may
+//  be drawn over several passes, their times are summed. Results are read
+//  from a ring of queries once the GPU has produced them, so collecting
+//  never waits unless asked to.
+class Gpu_Timer
+{
+public:
+	Gpu_Timer (size_t query_count = 16);
+	~Gpu_Timer();
+
+	Gpu_Timer (Gpu_Timer const&) = delete;
+	Gpu_Timer& operator= (Gpu_Timer const&) = delete;
+
+	// Passes can not be nested. When every query is still in flight the
+	//  oldest one is waited for.
+	void begin_pass();
+	void end_pass (bool frame_complete);
+
+	// Drops the passes of a frame which was restarted before completing.
+	void discard_frame();
+
+	// Returns the milliseconds of each frame whose passes have all finished.
+	std::vector<float> collect_frames (bool wait = false);
+
+private:
+	struct Query
+	{
+		GLuint id;
+		bool   frame_complete;
+		bool   frame_discarded;
+	};
+
+	std::vector<GLuint> free_queries;
+	std::deque<Query>   in_flight;
+	GLuint              active = 0;
+
+	// The passes of the oldest unfinished frame which were already read.
+	double frame_total   = 0.0;
+	bool   frame_invalid = false;
+
+	const std::chrono::steady_clock::time_point created
+		= std::chrono::steady_clock::now();
+
+	std::vector<float> finished_frames;
+
+	void read_oldest();
+};
+
+} // namespace renderer::gl
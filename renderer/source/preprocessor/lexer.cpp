@@ -1,5 +1,7 @@
 #include "lexer.hpp"
 
+#include "trace.hpp"
+
 #include <algorithm>
 #include <cassert>
 #include <sstream>
@@ -9,6 +11,7 @@ namespace renderer::preprocessor
 
 Lexer::Lexer (std::filesystem::path const& p_filepath) : filepath (p_filepath)
 {
+	TRACE_SCOPE ("Lexer");
 	auto file = io::load_file (filepath);
 	if (!file.exists)
 	{
@@ -1,5 +1,7 @@
 #include "parser.hpp"
 
+#include "trace.hpp"
+
 #include <iostream>
 
 namespace renderer::preprocessor
@@ -44,6 +46,7 @@ void Parser::process (
 	std::filesystem::path const& p_path,
 	bool                         is_implementation)
 {
+	TRACE_SCOPE ("Parser::process");
 	Lexer lexer (p_path);
 	if (!lexer.is_valid())
 	{
@@ -65,7 +68,11 @@ void Parser::process (
 	if (is_vertex_shader (p_path))
 		vertex_shader_code = glsl_shader_code;
 	else if (is_fragment_shader (p_path))
+	{
 		fragment_shader_code = glsl_shader_code;
+		for (std::string const& macro : defines)
+			fragment_shader_code = insert_define (fragment_shader_code, macro);
+	}
 }
 
 void Parser::parse (bool is_implementation)
@@ -90,6 +97,24 @@ void Parser::parse (bool is_implementation)
 					"which implements the required functions");
 		}
 
+		else if (
+			iterator->string.find ("#analytic_gradient") != std::string::npos)
+			defines.insert ("ANALYTIC_GRADIENT");
+
+		else if (
+			iterator->string.find ("#bounding_sphere") != std::string::npos)
+			defines.insert ("BOUNDING_SPHERE");
+
+		else if (iterator->string.find ("#bounding_box") != std::string::npos)
+			defines.insert ("BOUNDING_BOX");
+
+		else if (iterator->string.find ("#deep_zoom") != std::string::npos)
+			defines.insert ("DEEP_ZOOM");
+
+		else if (
+			iterator->string.find ("#double_float") != std::string::npos)
+			defines.insert ("DOUBLE_FLOAT");
+
 		else if (iterator->string.find ("#vertex_shader") != std::string::npos)
 		{
 			if (vertex_shader_code.empty())
@@ -353,6 +378,7 @@ int Parser::find_number (bool is_float)
 
 void Parser::include_file()
 {
+	TRACE_SCOPE ("Parser::include_file");
 	if (!expect_token (
 			Token_Type::String,
 			"#include should be followed by a file path."))
@@ -377,6 +403,7 @@ void Parser::include_file()
 		included_files = file_parser.included_files;
 		uniforms       = std::move (file_parser.uniforms);
 		struct_types   = std::move (file_parser.struct_types);
+		defines.insert (file_parser.defines.begin(), file_parser.defines.end());
 
 		if (file_parser.get_vertex_shader_code() != "")
 		{
@@ -467,6 +494,20 @@ void Parser::register_struct()
 void Parser::register_uniform()
 {
 	glsl_shader_code += iterator->string;
+
+	// Samplers are bound by the renderer rather than edited, they are passed
+	//  through without being exposed as uniforms.
+	std::vector<Token>::const_iterator type_iterator = iterator + 1;
+	skip_whitespace (type_iterator);
+	if (type_iterator != end_iterator
+		&& type_iterator->string.find ("sampler") != std::string::npos)
+	{
+		while (iterator + 1 != end_iterator
+			   && iterator->type != Token_Type::Semicolon)
+			glsl_shader_code += (++iterator)->string;
+		return;
+	}
+
 	std::unique_ptr<Variable> variable = parse_variable();
 	uniforms[variable->name]           = std::move (variable);
 }
@@ -603,4 +644,19 @@ std::vector<std::unique_ptr<Uniform>> Parser::get_uniforms() const
 	return uniform_variables;
 }
 
+std::string insert_define (std::string code, std::string const& macro)
+{
+	const std::string define = "#define " + macro + "\n";
+
+	const size_t version = code.find ("#version");
+	if (version == std::string::npos)
+		return define + code;
+
+	const size_t line_end = code.find ('\n', version);
+	if (line_end == std::string::npos)
+		return code + "\n" + define;
+
+	return code.insert (line_end + 1, define);
+}
+
 } // namespace renderer::preprocessor
@@ -7,6 +7,7 @@
 #include <cassert>
 #include <filesystem>
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -119,6 +120,16 @@ private:
 	std::string vertex_shader_code   = "";
 	std::string fragment_shader_code = "";
 
+	// Macros defined by directives which tell the shared code about optional
+	//  functions the distance estimator implements:
+	//  #analytic_gradient  vec3 gradient (vec3 position)
+	//  #bounding_sphere    vec4 bounding_sphere(), the centre and radius
+	//  #bounding_box       void bounding_box (out vec3 minimum,
+	//                                         out vec3 maximum)
+	//  #deep_zoom          float deep_zoom_DE (vec2 view_position)
+	//  #double_float       float double_float_DE (vec4 position)
+	std::set<std::string> defines;
+
 	void
 	process (std::filesystem::path const& path, bool should_be_implementation);
 
@@ -179,4 +190,7 @@ public:
 		std::filesystem::path const& path);
 };
 
+// Defines the macro right after #version, which has to stay the first line.
+std::string insert_define (std::string code, std::string const& macro);
+
 } // namespace renderer::preprocessor
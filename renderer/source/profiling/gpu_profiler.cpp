@@ -0,0 +1,73 @@
+#include "gpu_profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace renderer
+{
+
+void Gpu_Profiler::set_shader (std::string const& name, float compile_time)
+{
+	current                    = name;
+	histories[current].compile = compile_time;
+}
+
+void Gpu_Profiler::add_frames (std::vector<float> const& frame_times)
+{
+	if (frame_times.empty())
+	{
+		return;
+	}
+
+	History& history = histories[current];
+	for (float const frame_time : frame_times)
+	{
+		if (history.frames.size() < history_size)
+		{
+			history.frames.push_back (frame_time);
+		}
+		else
+		{
+			history.frames[history.next] = frame_time;
+		}
+		history.next = (history.next + 1) % history_size;
+	}
+	history.last = frame_times.back();
+}
+
+float Gpu_Profiler::get_last_frame_time() const
+{
+	const auto history = histories.find (current);
+	return history == histories.end() ? 0.0f : history->second.last;
+}
+
+std::map<std::string, Gpu_Statistics> Gpu_Profiler::get_statistics() const
+{
+	std::map<std::string, Gpu_Statistics> statistics;
+	for (auto const& [name, history] : histories)
+	{
+		Gpu_Statistics& summary = statistics[name];
+		summary.compile         = history.compile;
+		if (history.frames.empty())
+		{
+			continue;
+		}
+
+		std::vector<float> sorted = history.frames;
+		std::sort (sorted.begin(), sorted.end());
+
+		const size_t p99 = static_cast<size_t> (
+			std::ceil (0.99 * static_cast<double> (sorted.size())) - 1.0);
+
+		summary.last   = history.last;
+		summary.min    = sorted.front();
+		summary.mean   = std::accumulate (sorted.begin(), sorted.end(), 0.0f)
+					   / static_cast<float> (sorted.size());
+		summary.p99    = sorted[p99];
+		summary.frames = static_cast<unsigned int> (sorted.size());
+	}
+	return statistics;
+}
+
+} // namespace renderer
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "gpu_statistics.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace renderer
+{
+
+// Keeps the recent frame times of every shader which has been rendered.
+class Gpu_Profiler
+{
+public:
+	// Following frames are added to this shader.
+	void set_shader (std::string const& name, float compile_time);
+	void add_frames (std::vector<float> const& frame_times);
+
+	std::map<std::string, Gpu_Statistics> get_statistics() const;
+	float                                 get_last_frame_time() const;
+
+private:
+	static constexpr size_t history_size = 512;
+
+	struct History
+	{
+		std::vector<float> frames;
+		size_t             next    = 0;
+		float              last    = 0.0f;
+		float              compile = 0.0f;
+	};
+
+	std::map<std::string, History> histories;
+	std::string                    current;
+};
+
+} // namespace renderer
@@ -0,0 +1,187 @@
+#include "trace.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+
+struct Event
+{
+	char const*   name;
+	std::uint64_t begin;
+	std::uint64_t end;
+};
+
+// Only the owning thread appends, publishing each event through the count so
+//  that the writer can read the buffer without locking it.
+struct Thread_Buffer
+{
+	static constexpr size_t capacity = 1 << 16;
+
+	unsigned int             thread_id;
+	std::unique_ptr<Event[]> events{new Event[capacity]};
+	std::atomic<size_t>      count{0};
+	std::atomic<size_t>      dropped{0};
+};
+
+// Buffers outlive their threads so that the zones of finished threads are
+//  still written.
+struct Registry
+{
+	std::mutex                                  mutex;
+	std::vector<std::unique_ptr<Thread_Buffer>> buffers;
+	std::filesystem::path                       path;
+	const std::chrono::steady_clock::time_point epoch
+		= std::chrono::steady_clock::now();
+};
+
+Registry& registry()
+{
+	static Registry instance;
+	return instance;
+}
+
+thread_local Thread_Buffer* thread_buffer = nullptr;
+
+Thread_Buffer& local_buffer()
+{
+	if (thread_buffer == nullptr)
+	{
+		Registry&                   instance = registry();
+		std::lock_guard<std::mutex> lock (instance.mutex);
+		instance.buffers.push_back (std::make_unique<Thread_Buffer>());
+		thread_buffer            = instance.buffers.back().get();
+		thread_buffer->thread_id = static_cast<unsigned int> (
+			instance.buffers.size());
+	}
+	return *thread_buffer;
+}
+
+void write_events (
+	std::ostream&        stream,
+	Thread_Buffer const& buffer,
+	bool&                first)
+{
+	const size_t count = buffer.count.load (std::memory_order_acquire);
+	for (size_t i = 0; i < count; ++i)
+	{
+		Event const& event = buffer.events[i];
+		stream << (first ? "\n" : ",\n") << "{\"name\":\"" << event.name
+			   << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer.thread_id
+			   << ",\"ts\":" << event.begin / 1000.0
+			   << ",\"dur\":" << (event.end - event.begin) / 1000.0 << "}";
+		first = false;
+	}
+}
+
+// Records the whole run of the program when the environment asks for it.
+struct Environment_Trace
+{
+	Environment_Trace()
+	{
+		// Created first so that it is destroyed after the trace is written.
+		registry();
+
+		if (char const* path = std::getenv ("RENDERER_TRACE"))
+		{
+			renderer::trace::start (path);
+		}
+	}
+
+	~Environment_Trace()
+	{
+		renderer::trace::stop();
+	}
+};
+
+const Environment_Trace environment_trace;
+
+} // namespace
+
+namespace renderer::trace
+{
+
+namespace detail
+{
+std::atomic<bool> recording{false};
+
+std::uint64_t now()
+{
+	const std::chrono::nanoseconds elapsed
+		= std::chrono::steady_clock::now() - registry().epoch;
+	return static_cast<std::uint64_t> (elapsed.count());
+}
+
+void record (char const* name, std::uint64_t begin, std::uint64_t end)
+{
+	Thread_Buffer& buffer = local_buffer();
+	const size_t   index  = buffer.count.load (std::memory_order_relaxed);
+	if (index == Thread_Buffer::capacity)
+	{
+		buffer.dropped.fetch_add (1, std::memory_order_relaxed);
+		return;
+	}
+
+	buffer.events[index] = {name, begin, end};
+	buffer.count.store (index + 1, std::memory_order_release);
+}
+} // namespace detail
+
+void start (std::filesystem::path const& path)
+{
+	Registry&                   instance = registry();
+	std::lock_guard<std::mutex> lock (instance.mutex);
+	for (std::unique_ptr<Thread_Buffer>& buffer : instance.buffers)
+	{
+		buffer->count   = 0;
+		buffer->dropped = 0;
+	}
+	instance.path = path;
+	detail::recording.store (true);
+}
+
+void stop()
+{
+	if (!detail::recording.exchange (false))
+	{
+		return;
+	}
+
+	Registry&                   instance = registry();
+	std::lock_guard<std::mutex> lock (instance.mutex);
+
+	std::ofstream file (instance.path);
+	if (!file.is_open())
+	{
+		std::cerr << "Could not write the trace to " << instance.path.string()
+				  << "\n";
+		return;
+	}
+
+	// Timestamps are in microseconds, keep nanosecond precision.
+	file << std::fixed << std::setprecision (3);
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool   first   = true;
+	size_t dropped = 0;
+	for (std::unique_ptr<Thread_Buffer> const& buffer : instance.buffers)
+	{
+		write_events (file, *buffer, first);
+		dropped += buffer->dropped.load();
+	}
+	file << "\n]}\n";
+
+	if (dropped != 0)
+	{
+		std::cerr << "The trace buffers were full, " << dropped
+				  << " zones were dropped.\n";
+	}
+}
+
+} // namespace renderer::trace
@@ -0,0 +1,134 @@
+#include "quality_governor.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace renderer
+{
+
+void Quality_Governor::set_target_frame_time (float milliseconds)
+{
+	target_frame_time = std::max (milliseconds, 0.0f);
+}
+
+void Quality_Governor::set_minimum_scale (float p_scale)
+{
+	minimum_scale = std::clamp (p_scale, 0.05f, 1.0f);
+	split_cost();
+}
+
+void Quality_Governor::set_minimum_budget (float fraction)
+{
+	minimum_budget = std::clamp (fraction, 0.0f, 1.0f);
+	split_cost();
+}
+
+void Quality_Governor::set_budget_uniforms (
+	std::vector<std::string> const& names)
+{
+	budget_uniforms = names;
+}
+
+bool Quality_Governor::is_budget_uniform (std::string const& name) const
+{
+	return std::find (budget_uniforms.begin(), budget_uniforms.end(), name)
+		   != budget_uniforms.end();
+}
+
+void Quality_Governor::set_full_budget (
+	std::string const& name,
+	unsigned int       value)
+{
+	full_budgets[name] = value;
+	split_cost();
+}
+
+void Quality_Governor::clear_budgets()
+{
+	full_budgets.clear();
+	split_cost();
+}
+
+std::map<std::string, unsigned int> Quality_Governor::get_budgets() const
+{
+	const float fraction = is_interacting() ? budget : 1.0f;
+
+	std::map<std::string, unsigned int> budgets;
+	for (auto const& [name, full] : full_budgets)
+	{
+		const auto lowered = static_cast<unsigned int> (
+			std::lround (static_cast<float> (full) * fraction));
+		budgets[name] = std::clamp (lowered, std::min (full, 1u), full);
+	}
+	return budgets;
+}
+
+std::map<std::string, unsigned int> Quality_Governor::get_full_budgets() const
+{
+	return full_budgets;
+}
+
+void Quality_Governor::notify_interaction()
+{
+	last_interaction = Clock::now();
+}
+
+bool Quality_Governor::is_interacting() const
+{
+	return target_frame_time > 0.0f
+		   && Clock::now() - last_interaction < interaction_hold;
+}
+
+float Quality_Governor::get_scale() const
+{
+	return is_interacting() ? scale : 1.0f;
+}
+
+void Quality_Governor::add_frame_times (std::vector<float> const& milliseconds)
+{
+	if (target_frame_time <= 0.0f || !is_interacting())
+	{
+		return;
+	}
+
+	const float minimum_cost = minimum_scale * minimum_scale
+							   * (full_budgets.empty() ? 1.0f : minimum_budget);
+	for (float const frame_time : milliseconds)
+	{
+		if (frame_time <= 0.0f)
+		{
+			continue;
+		}
+
+		// Move half way towards the cost which would have met the target, to
+		//  damp the noise in the timings.
+		const float ideal_cost = cost * target_frame_time / frame_time;
+		cost = std::clamp (0.5f * (cost + ideal_cost), minimum_cost, 1.0f);
+	}
+	split_cost();
+}
+
+void Quality_Governor::split_cost()
+{
+	// The cost of a frame is roughly the number of pixels times the budget
+	//  per pixel, so both are lowered by the same factor until one of them
+	//  reaches its minimum and the other takes the rest.
+	const float minimum_pixels = minimum_scale * minimum_scale;
+	if (full_budgets.empty())
+	{
+		budget = 1.0f;
+	}
+	else
+	{
+		budget = std::clamp (std::sqrt (cost), minimum_budget, 1.0f);
+	}
+
+	const float pixels = std::clamp (cost / budget, minimum_pixels, 1.0f);
+	if (!full_budgets.empty())
+	{
+		budget = std::clamp (cost / pixels, minimum_budget, 1.0f);
+	}
+	scale = std::sqrt (pixels);
+}
+
+} // namespace renderer
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace renderer
+{
+
+// Lowers the quality of frames while the camera is moving, so that the
+//  measured GPU frame time approaches the target. Two knobs are turned, the
+//  fraction of the full resolution rendered and the fraction of the step or
+//  iteration budgets, each within its minimum. Once the interaction stops
+//  both return to full quality.
+class Quality_Governor
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	void set_target_frame_time (float milliseconds);
+	void set_minimum_scale (float scale);
+	void set_minimum_budget (float fraction);
+
+	// Names of the unsigned integer uniforms which cap the work per pixel,
+	//  such as the steps of a ray march or the iterations of a fractal.
+	void set_budget_uniforms (std::vector<std::string> const& names);
+	bool is_budget_uniform (std::string const& name) const;
+
+	// The value set by the user is full quality.
+	void set_full_budget (std::string const& name, unsigned int value);
+	void clear_budgets();
+
+	// Budget uniforms of the current shader with the value to upload for the
+	//  current quality.
+	std::map<std::string, unsigned int> get_budgets() const;
+	std::map<std::string, unsigned int> get_full_budgets() const;
+
+	void notify_interaction();
+	bool is_interacting() const;
+
+	float get_scale() const;
+	void  add_frame_times (std::vector<float> const& milliseconds);
+
+private:
+	// Motion arrives in bursts of input events, keep the reduced quality for
+	//  a short while so the frames in between do not flicker to full quality.
+	static constexpr std::chrono::milliseconds interaction_hold{150};
+
+	float target_frame_time = 0.0f;
+	float minimum_scale     = 0.25f;
+	float minimum_budget    = 0.25f;
+
+	// Fraction of the cost of a full quality frame, the product of the pixel
+	//  fraction and the budget fraction.
+	float cost   = 1.0f;
+	float scale  = 1.0f;
+	float budget = 1.0f;
+
+	std::vector<std::string>            budget_uniforms;
+	std::map<std::string, unsigned int> full_budgets;
+
+	Clock::time_point last_interaction;
+
+	void split_cost();
+};
+
+} // namespace renderer
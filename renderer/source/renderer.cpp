@@ -1,10 +1,22 @@
 #include "renderer.hpp"
 
+#include "cost_overlay.hpp"
+#include "deep_zoom.hpp"
+#include "fence_queue.hpp"
 #include "file_loader.hpp"
+#include "framebuffer.hpp"
 #include "gl_interface.hpp"
+#include "gpu_profiler.hpp"
 #include "parser.hpp"
+#include "quality_governor.hpp"
+#include "readback_ring.hpp"
 #include "shader.hpp"
+#include "tile_cache.hpp"
+#include "tiled_render.hpp"
+#include "trace.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 
 namespace renderer
@@ -13,11 +25,29 @@ namespace renderer
 Renderer::Renderer()
 {
 	gl::init();
-	shader = new Shader();
+	shader         = new Shader();
+	scaled_target  = new Framebuffer();
+	capture_target = new Framebuffer();
+	governor       = new Quality_Governor();
+	readback       = new Readback_Ring();
+	profiler       = new Gpu_Profiler();
+	cost_overlay   = new Cost_Overlay();
+	completions    = new gl::Fence_Queue();
+	tile_cache     = new Tile_Cache (*shader);
+	deep_zoom      = new Deep_Zoom (*shader);
 }
 
 Renderer::~Renderer()
 {
+	delete deep_zoom;
+	delete tile_cache;
+	delete completions;
+	delete cost_overlay;
+	delete profiler;
+	delete readback;
+	delete capture_target;
+	delete governor;
+	delete scaled_target;
 	delete shader;
 }
 
@@ -25,6 +55,7 @@ std::vector<std::filesystem::path> Renderer::get_shaders (
 	std::filesystem::path const&              include_path,
 	std::vector<std::filesystem::path> const& paths)
 {
+	TRACE_SCOPE ("Renderer::get_shaders");
 	std::vector<std::filesystem::path> shaders;
 	for (io::file_query<std::filesystem::path> const& file :
 		 io::load_recursive (paths, "frag"))
@@ -49,25 +80,448 @@ std::vector<std::filesystem::path> Renderer::get_shaders (
 }
 
 std::vector<std::unique_ptr<Uniform>> Renderer::set_shader (
-	std::filesystem::path const& include_path,
+	std::filesystem::path const& p_include_path,
 	std::filesystem::path const& shader_path)
 {
-	return shader->change_shader (include_path, shader_path);
+	resolution_width  = 0;
+	resolution_height = 0;
+	include_path      = p_include_path;
+
+	// Frames of the previous shader must not count towards the new one.
+	collect_frame_times (true);
+	governor->clear_budgets();
+	uploaded_budgets.clear();
+	std::vector<std::unique_ptr<Uniform>> uniforms
+		= shader->change_shader (p_include_path, shader_path);
+	profiler->set_shader (
+		shader_path.stem().string(),
+		shader->get_compile_time());
+	tile_cache->set_shader (shader_path.stem().string(), uniforms);
+	deep_zoom->set_shader (uniforms);
+
+	// The renderer sets the deep zoom uniforms itself.
+	uniforms.erase (
+		std::remove_if (
+			uniforms.begin(),
+			uniforms.end(),
+			[] (std::unique_ptr<Uniform> const& uniform)
+			{ return uniform->get_name().rfind ("deep_zoom.", 0) == 0; }),
+		uniforms.end());
+	return uniforms;
 }
 
 void Renderer::set_uniform (Uniform const& uniform)
 {
+	auto const* budget
+		= dynamic_cast<Typed_Uniform<unsigned int> const*> (&uniform);
+	if (budget != nullptr && budget->get_values().size() == 1
+		&& governor->is_budget_uniform (uniform.get_name()))
+	{
+		governor->set_full_budget (
+			uniform.get_name(),
+			budget->get_values().front());
+		uploaded_budgets.erase (uniform.get_name());
+		apply_budgets (governor->get_budgets());
+		return;
+	}
+
+	tile_cache->set_uniform (uniform);
+	deep_zoom->set_uniform (uniform);
 	shader->set_uniform (uniform);
 }
 
-void Renderer::render (unsigned int width, unsigned int height)
+void Renderer::set_target_frame_time (float milliseconds)
+{
+	governor->set_target_frame_time (milliseconds);
+}
+
+void Renderer::set_minimum_render_scale (float scale)
+{
+	governor->set_minimum_scale (scale);
+}
+
+void Renderer::set_budget_uniforms (std::vector<std::string> const& names)
+{
+	governor->set_budget_uniforms (names);
+}
+
+void Renderer::set_minimum_budget (float fraction)
+{
+	governor->set_minimum_budget (fraction);
+}
+
+void Renderer::notify_interaction()
+{
+	governor->notify_interaction();
+}
+
+void Renderer::set_frame_budget (float milliseconds)
+{
+	const std::chrono::microseconds budget (
+		static_cast<long long> (milliseconds * 1000.0f));
+	shader->set_frame_budget (budget);
+	tile_cache->set_frame_budget (budget);
+}
+
+void Renderer::set_tile_cache_budget (unsigned int megabytes)
+{
+	tile_cache->set_memory_budget (std::size_t{megabytes} << 20);
+}
+
+bool Renderer::set_deep_zoom (
+	std::string const& real,
+	std::string const& imaginary,
+	double             width)
+{
+	return deep_zoom->set_view (real, imaginary, width)
+		   && deep_zoom->is_active();
+}
+
+void Renderer::disable_deep_zoom()
+{
+	deep_zoom->disable();
+}
+
+bool Renderer::render (unsigned int width, unsigned int height)
+{
+	TRACE_SCOPE ("Renderer::render");
+	readback->poll();
+	completions->poll();
+	collect_frame_times();
+	update_resolution (width, height);
+	deep_zoom->update();
+
+	if (cost_overlay_enabled)
+	{
+		apply_budgets (governor->get_budgets());
+		draw_frame (width, height);
+		return true;
+	}
+
+	// Cached tiles are drawn at full quality, they outlive the interaction.
+	if (governor->is_interacting() && tile_cache->is_active()
+		&& !deep_zoom->is_active())
+	{
+		apply_budgets (governor->get_full_budgets());
+		if (tile_cache->render (width, height))
+		{
+			rendered_scaled = true;
+			return false;
+		}
+	}
+
+	// Lowers the budgets while interacting and restores them afterwards.
+	apply_budgets (governor->get_budgets());
+
+	if (!governor->is_interacting())
+	{
+		// The upscaled frames overwrote the target, start the full
+		//  resolution frame over.
+		if (rendered_scaled)
+		{
+			shader->restart_frame();
+			rendered_scaled = false;
+		}
+		return shader->render (width, height);
+	}
+
+	render_scaled (width, height);
+
+	// Keep frames coming so that full resolution is restored once the
+	//  camera stops.
+	return false;
+}
+
+Image Renderer::render_image (unsigned int width, unsigned int height)
+{
+	GLint previous_framebuffer = 0;
+	GLint viewport[4]          = {};
+	glGetIntegerv (GL_DRAW_FRAMEBUFFER_BINDING, &previous_framebuffer);
+	glGetIntegerv (GL_VIEWPORT, viewport);
+
+	update_resolution (width, height);
+	deep_zoom->update();
+
+	Framebuffer target;
+	target.resize (width, height);
+	target.bind();
+	glViewport (
+		0,
+		0,
+		static_cast<GLsizei> (width),
+		static_cast<GLsizei> (height));
+	draw_frame (width, height);
+
+	std::vector<std::uint8_t> rgba (size_t{width} * height * 4);
+	glPixelStorei (GL_PACK_ALIGNMENT, 1);
+	glReadPixels (
+		0,
+		0,
+		static_cast<GLsizei> (width),
+		static_cast<GLsizei> (height),
+		GL_RGBA,
+		GL_UNSIGNED_BYTE,
+		rgba.data());
+
+	glBindFramebuffer (
+		GL_FRAMEBUFFER,
+		static_cast<GLuint> (previous_framebuffer));
+	glViewport (viewport[0], viewport[1], viewport[2], viewport[3]);
+
+	return image_from_readback (width, height, rgba);
+}
+
+void Renderer::capture_frame (
+	unsigned int                       width,
+	unsigned int                       height,
+	std::function<void (Image)> const& callback)
+{
+	GLint previous_read_framebuffer = 0;
+	GLint draw_framebuffer          = 0;
+	glGetIntegerv (GL_READ_FRAMEBUFFER_BINDING, &previous_read_framebuffer);
+	glGetIntegerv (GL_DRAW_FRAMEBUFFER_BINDING, &draw_framebuffer);
+
+	glBindFramebuffer (
+		GL_READ_FRAMEBUFFER,
+		static_cast<GLuint> (draw_framebuffer));
+	readback->read (width, height, callback);
+	glBindFramebuffer (
+		GL_READ_FRAMEBUFFER,
+		static_cast<GLuint> (previous_read_framebuffer));
+}
+
+void Renderer::render_capture (
+	unsigned int                       width,
+	unsigned int                       height,
+	std::function<void (Image)> const& callback)
+{
+	GLint previous_framebuffer = 0;
+	GLint viewport[4]          = {};
+	glGetIntegerv (GL_DRAW_FRAMEBUFFER_BINDING, &previous_framebuffer);
+	glGetIntegerv (GL_VIEWPORT, viewport);
+
+	readback->poll();
+	update_resolution (width, height);
+	deep_zoom->update();
+
+	// Reusing one target is safe, the copy into the pixel buffer is ordered
+	//  before the draws of the next frame.
+	capture_target->resize (width, height);
+	capture_target->bind();
+	glViewport (
+		0,
+		0,
+		static_cast<GLsizei> (width),
+		static_cast<GLsizei> (height));
+	draw_frame (width, height);
+	capture_frame (width, height, callback);
+
+	glBindFramebuffer (
+		GL_FRAMEBUFFER,
+		static_cast<GLuint> (previous_framebuffer));
+	glViewport (viewport[0], viewport[1], viewport[2], viewport[3]);
+}
+
+void Renderer::poll_captures (bool wait)
+{
+	readback->poll (wait);
+}
+
+bool Renderer::has_pending_captures() const
 {
+	return readback->is_pending();
+}
+
+void Renderer::notify_when_complete (
+	std::function<void (std::chrono::steady_clock::time_point)> callback)
+{
+	completions->push (std::move (callback));
+}
+
+bool Renderer::has_pending_notifications() const
+{
+	return completions->is_pending();
+}
+
+void Renderer::set_frames_in_flight (unsigned int frames)
+{
+	delete readback;
+	readback = new Readback_Ring (std::max (1u, frames));
+}
+
+bool Renderer::render_tiled (
+	std::filesystem::path const&                            output,
+	unsigned int                                            width,
+	unsigned int                                            height,
+	unsigned int                                            tile_size,
+	std::string const&                                      job,
+	std::function<void (unsigned int, unsigned int)> const& progress)
+{
+	GLint previous_framebuffer = 0;
+	GLint viewport[4]          = {};
+	glGetIntegerv (GL_DRAW_FRAMEBUFFER_BINDING, &previous_framebuffer);
+	glGetIntegerv (GL_VIEWPORT, viewport);
+
+	update_resolution (width, height);
+	deep_zoom->update();
+
+	Tiled_Render tiled_render (*shader, width, height, tile_size);
+	const bool   success = tiled_render.run (output, job, progress);
+
+	glBindFramebuffer (
+		GL_FRAMEBUFFER,
+		static_cast<GLuint> (previous_framebuffer));
+	glViewport (viewport[0], viewport[1], viewport[2], viewport[3]);
+	return success;
+}
+
+void Renderer::set_cost_overlay (bool enabled)
+{
+	cost_overlay_enabled = enabled && cost_overlay->load (include_path);
+	shader->restart_frame();
+}
+
+std::vector<unsigned int> Renderer::get_cost_histogram (unsigned int bins) const
+{
+	return cost_overlay->histogram (bins);
+}
+
+double Renderer::get_mean_cost() const
+{
+	return cost_overlay->mean_cost();
+}
+
+void Renderer::set_cone_prepass (bool enabled)
+{
+	shader->set_cone_prepass (enabled);
+}
+
+unsigned long long Renderer::get_skipped_steps() const
+{
+	return shader->get_skipped_steps();
+}
+
+void Renderer::set_deferred_shading (bool enabled)
+{
+	shader->set_deferred_shading (enabled);
+}
+
+std::map<std::string, Gpu_Statistics>
+Renderer::get_gpu_statistics (bool wait)
+{
+	collect_frame_times (wait);
+	return profiler->get_statistics();
+}
+
+float Renderer::get_last_gpu_frame_time() const
+{
+	return profiler->get_last_frame_time();
+}
+
+void Renderer::apply_budgets (
+	std::map<std::string, unsigned int> const& budgets)
+{
+	for (auto const& [name, value] : budgets)
+	{
+		auto uploaded = uploaded_budgets.find (name);
+		if (uploaded != uploaded_budgets.end() && uploaded->second == value)
+		{
+			continue;
+		}
+
+		const Typed_Uniform<unsigned int> uniform (name, {value});
+		tile_cache->set_uniform (uniform);
+		deep_zoom->set_uniform (uniform);
+		shader->set_uniform (uniform);
+		uploaded_budgets[name] = value;
+	}
+}
+
+void Renderer::collect_frame_times (bool wait)
+{
+	const std::vector<float> frame_times = shader->collect_frame_times (wait);
+	governor->add_frame_times (frame_times);
+	profiler->add_frames (frame_times);
+}
+
+void Renderer::draw_frame (unsigned int width, unsigned int height)
+{
+	if (cost_overlay_enabled)
+	{
+		cost_overlay->draw (width, height, [this] { shader->draw(); });
+	}
+	else
+	{
+		shader->draw();
+	}
+}
+
+void Renderer::update_resolution (unsigned int width, unsigned int height)
+{
+	// Only resend the resolution when it changes, every upload restarts a
+	//  tiled frame.
+	if (width == resolution_width && height == resolution_height)
+	{
+		return;
+	}
+
 	Typed_Uniform<unsigned int> resolution (
 		"v_globals.resolution",
 		{width, height});
 	set_uniform (resolution);
 
-	shader->render();
+	resolution_width  = width;
+	resolution_height = height;
+}
+
+void Renderer::render_scaled (unsigned int width, unsigned int height)
+{
+	TRACE_SCOPE ("Renderer::render_scaled");
+	const float        scale = governor->get_scale();
+	const unsigned int scaled_width
+		= std::max (1u, static_cast<unsigned int> (width * scale));
+	const unsigned int scaled_height
+		= std::max (1u, static_cast<unsigned int> (height * scale));
+
+	GLint target_framebuffer = 0;
+	GLint viewport[4]        = {};
+	glGetIntegerv (GL_DRAW_FRAMEBUFFER_BINDING, &target_framebuffer);
+	glGetIntegerv (GL_VIEWPORT, viewport);
+
+	// The resolution uniform keeps describing the full frame so the view
+	//  stays the same, only the viewport covers fewer pixels. The offscreen
+	//  target is allocated at full size to avoid reallocating as the scale
+	//  changes.
+	scaled_target->resize (width, height);
+	scaled_target->bind();
+	glViewport (
+		0,
+		0,
+		static_cast<GLsizei> (scaled_width),
+		static_cast<GLsizei> (scaled_height));
+	shader->draw();
+
+	glBindFramebuffer (GL_READ_FRAMEBUFFER, scaled_target->get_id());
+	glBindFramebuffer (
+		GL_DRAW_FRAMEBUFFER,
+		static_cast<GLuint> (target_framebuffer));
+	glBlitFramebuffer (
+		0,
+		0,
+		static_cast<GLint> (scaled_width),
+		static_cast<GLint> (scaled_height),
+		0,
+		0,
+		static_cast<GLint> (width),
+		static_cast<GLint> (height),
+		GL_COLOR_BUFFER_BIT,
+		GL_LINEAR);
+
+	glBindFramebuffer (
+		GL_FRAMEBUFFER,
+		static_cast<GLuint> (target_framebuffer));
+	glViewport (viewport[0], viewport[1], viewport[2], viewport[3]);
+	rendered_scaled = true;
 }
 
 } // namespace renderer
@@ -0,0 +1,185 @@
+#include "cone_prepass.hpp"
+
+#include "gl_interface.hpp"
+#include "parser.hpp"
+#include "trace.hpp"
+
+#include <iostream>
+#include <vector>
+
+namespace renderer
+{
+
+Cone_Prepass::Cone_Prepass()
+{
+	const float zero[2] = {0.0f, 0.0f};
+	glGenTextures (1, &zero_texture);
+	glBindTexture (GL_TEXTURE_2D, zero_texture);
+	glTexImage2D (GL_TEXTURE_2D, 0, GL_RG32F, 1, 1, 0, GL_RG, GL_FLOAT, zero);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glBindTexture (GL_TEXTURE_2D, 0);
+}
+
+Cone_Prepass::~Cone_Prepass()
+{
+	glDeleteProgram (program_id);
+	glDeleteTextures (1, &zero_texture);
+}
+
+bool Cone_Prepass::load (
+	std::string const& vertex_shader_code,
+	std::string const& fragment_shader_code)
+{
+	unload();
+	if (fragment_shader_code.find ("CONE_PREPASS") == std::string::npos)
+	{
+		return false;
+	}
+
+	auto [success, new_program_id] = gl::create_program (
+		vertex_shader_code,
+		preprocessor::insert_define (fragment_shader_code, "CONE_PREPASS"));
+	if (!success)
+	{
+		std::cerr << "Failed to create the cone prepass program.\n";
+		return false;
+	}
+	program_id = new_program_id;
+
+	gl::set_uniform (program_id, Typed_Uniform<int> ("ray_start", {0}));
+	return true;
+}
+
+void Cone_Prepass::unload()
+{
+	glDeleteProgram (program_id);
+	program_id = 0;
+	drawn      = false;
+}
+
+void Cone_Prepass::set_enabled (bool p_enabled)
+{
+	enabled = p_enabled;
+	drawn   = drawn && enabled;
+}
+
+bool Cone_Prepass::is_active() const
+{
+	return enabled && program_id != 0;
+}
+
+void Cone_Prepass::set_uniform (Uniform const& uniform)
+{
+	if (program_id != 0)
+	{
+		gl::set_uniform (program_id, uniform);
+	}
+}
+
+void Cone_Prepass::draw()
+{
+	if (!is_active())
+	{
+		return;
+	}
+
+	TRACE_SCOPE ("Cone_Prepass::draw");
+	GLint previous_framebuffer = 0;
+	GLint viewport[4]          = {};
+	glGetIntegerv (GL_DRAW_FRAMEBUFFER_BINDING, &previous_framebuffer);
+	glGetIntegerv (GL_VIEWPORT, viewport);
+
+	frame_width  = static_cast<unsigned int> (viewport[2]);
+	frame_height = static_cast<unsigned int> (viewport[3]);
+	const unsigned int coarse_width
+		= (frame_width + coarse_divisor - 1) / coarse_divisor;
+	const unsigned int coarse_height
+		= (frame_height + coarse_divisor - 1) / coarse_divisor;
+	coarse.resize (coarse_width, coarse_height);
+	fine.resize (coarse_width * 2, coarse_height * 2);
+
+	const bool scissor = glIsEnabled (GL_SCISSOR_TEST);
+	glDisable (GL_SCISSOR_TEST);
+	glUseProgram (program_id);
+	draw_level (coarse, zero_texture);
+	draw_level (fine, coarse.get_texture (0));
+	glUseProgram (0);
+	if (scissor)
+	{
+		glEnable (GL_SCISSOR_TEST);
+	}
+
+	glBindFramebuffer (
+		GL_FRAMEBUFFER,
+		static_cast<GLuint> (previous_framebuffer));
+	glViewport (viewport[0], viewport[1], viewport[2], viewport[3]);
+	drawn = true;
+}
+
+void Cone_Prepass::draw_level (Framebuffer& level, GLuint parent_texture)
+{
+	level.bind();
+	glViewport (
+		0,
+		0,
+		static_cast<GLsizei> (level.get_width()),
+		static_cast<GLsizei> (level.get_height()));
+	glActiveTexture (GL_TEXTURE0);
+	glBindTexture (GL_TEXTURE_2D, parent_texture);
+	screen_vertices.render();
+	glBindTexture (GL_TEXTURE_2D, 0);
+}
+
+void Cone_Prepass::bind() const
+{
+	glActiveTexture (GL_TEXTURE0);
+	glBindTexture (
+		GL_TEXTURE_2D,
+		drawn && is_active() ? fine.get_texture (0) : zero_texture);
+}
+
+void Cone_Prepass::unbind() const
+{
+	glActiveTexture (GL_TEXTURE0);
+	glBindTexture (GL_TEXTURE_2D, 0);
+}
+
+unsigned long long Cone_Prepass::get_skipped_steps() const
+{
+	const size_t texels = size_t{fine.get_width()} * fine.get_height();
+	if (!drawn || texels == 0)
+	{
+		return 0;
+	}
+
+	GLint previous_framebuffer = 0;
+	glGetIntegerv (GL_READ_FRAMEBUFFER_BINDING, &previous_framebuffer);
+
+	std::vector<float> starts (texels * 2);
+	glBindFramebuffer (GL_READ_FRAMEBUFFER, fine.get_id());
+	glPixelStorei (GL_PACK_ALIGNMENT, 1);
+	glReadPixels (
+		0,
+		0,
+		static_cast<GLsizei> (fine.get_width()),
+		static_cast<GLsizei> (fine.get_height()),
+		GL_RG,
+		GL_FLOAT,
+		starts.data());
+	glBindFramebuffer (
+		GL_READ_FRAMEBUFFER,
+		static_cast<GLuint> (previous_framebuffer));
+
+	double steps = 0.0;
+	for (size_t i = 0; i < texels; ++i)
+	{
+		steps += starts[i * 2 + 1];
+	}
+
+	// Each texel covers the same share of the frame's pixels.
+	const double pixels = double (frame_width) * frame_height;
+	return static_cast<unsigned long long> (steps * pixels / texels);
+}
+
+} // namespace renderer
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "framebuffer.hpp"
+#include "screen_vertex_array.hpp"
+#include "uniform.hpp"
+
+#include <GL/glew.h>
+
+#include <string>
+
+namespace renderer
+{
+
+// Marches cones through the frame at an eighth and then a quarter of its
+//  resolution before the full resolution pass. Each texel stores how far
+//  every ray inside it can skip without missing a surface, the ray marcher
+//  samples this and resumes from there. Fragment shaders opt in with an
+//  #ifdef CONE_PREPASS variant of their main.
+class Cone_Prepass
+{
+public:
+	Cone_Prepass();
+	~Cone_Prepass();
+
+	Cone_Prepass (Cone_Prepass const&) = delete;
+	Cone_Prepass& operator= (Cone_Prepass const&) = delete;
+
+	// Compiles the prepass variant of the shader, returns false for shaders
+	//  which have none.
+	bool load (
+		std::string const& vertex_shader_code,
+		std::string const& fragment_shader_code);
+	void unload();
+
+	void set_enabled (bool enabled);
+	bool is_active() const;
+
+	// Every uniform of the shader is needed to march the same scene.
+	void set_uniform (Uniform const& uniform);
+
+	// Marches the levels for the bound viewport, leaving the framebuffer and
+	//  viewport as they were.
+	void draw();
+
+	// Binds the distances of the last draw to the first texture unit, or
+	//  zeros when the prepass is not active.
+	void bind() const;
+	void unbind() const;
+
+	// Ray march steps which the last frame skipped across all its pixels.
+	unsigned long long get_skipped_steps() const;
+
+private:
+	static constexpr unsigned int coarse_divisor = 8;
+
+	GLuint              program_id   = 0;
+	GLuint              zero_texture = 0;
+	bool                enabled      = true;
+	bool                drawn        = false;
+	Screen_Vertex_Array screen_vertices;
+
+	// The fine level has exactly twice the texels of the coarse one, so its
+	//  texels never straddle two coarse ones.
+	Framebuffer coarse{{GL_RG32F}};
+	Framebuffer fine{{GL_RG32F}};
+
+	unsigned int frame_width  = 0;
+	unsigned int frame_height = 0;
+
+	void draw_level (Framebuffer& level, GLuint parent_texture);
+};
+
+} // namespace renderer
@@ -0,0 +1,169 @@
+#include "deferred_shading.hpp"
+
+#include "gl_interface.hpp"
+#include "parser.hpp"
+#include "trace.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+namespace renderer
+{
+
+Deferred_Shading::~Deferred_Shading()
+{
+	unload();
+}
+
+bool Deferred_Shading::load (
+	std::string const& vertex_shader_code,
+	std::string const& fragment_shader_code)
+{
+	unload();
+	if (fragment_shader_code.find ("G_BUFFER") == std::string::npos)
+	{
+		return false;
+	}
+
+	attachments = 0;
+	while (attachments < max_attachments
+		   && fragment_shader_code.find (
+				  "g_buffer_" + std::to_string (attachments))
+				  != std::string::npos)
+	{
+		++attachments;
+	}
+	g_buffer = std::make_unique<Framebuffer> (
+		std::vector<GLenum> (attachments, GL_RGBA32F));
+
+	auto [geometry_success, new_geometry_program] = gl::create_program (
+		vertex_shader_code,
+		preprocessor::insert_define (fragment_shader_code, "G_BUFFER"));
+	auto [shading_success, new_shading_program] = gl::create_program (
+		vertex_shader_code,
+		preprocessor::insert_define (fragment_shader_code, "DEFERRED_SHADING"));
+	geometry_program = new_geometry_program;
+	shading_program  = new_shading_program;
+	if (!geometry_success || !shading_success)
+	{
+		std::cerr << "Failed to create the deferred shading programs.\n";
+		unload();
+		return false;
+	}
+
+	// The cone prepass keeps the first texture unit.
+	gl::set_uniform (geometry_program, Typed_Uniform<int> ("ray_start", {0}));
+	for (unsigned int i = 0; i < attachments; ++i)
+	{
+		gl::set_uniform (
+			shading_program,
+			Typed_Uniform<int> (
+				"g_buffer_" + std::to_string (i),
+				{static_cast<int> (i + 1)}));
+	}
+	return true;
+}
+
+void Deferred_Shading::unload()
+{
+	glDeleteProgram (geometry_program);
+	glDeleteProgram (shading_program);
+	geometry_program = 0;
+	shading_program  = 0;
+	geometry_drawn   = false;
+}
+
+void Deferred_Shading::set_enabled (bool p_enabled)
+{
+	enabled        = p_enabled;
+	geometry_drawn = geometry_drawn && enabled;
+}
+
+bool Deferred_Shading::is_active() const
+{
+	return enabled && geometry_program != 0;
+}
+
+void Deferred_Shading::set_uniform (Uniform const& uniform)
+{
+	if (geometry_program == 0)
+	{
+		return;
+	}
+
+	gl::set_uniform (geometry_program, uniform);
+	gl::set_uniform (shading_program, uniform);
+
+	// The driver drops uniforms which a program never reads.
+	const std::string name = uniform.get_name();
+	if (glGetUniformLocation (geometry_program, name.c_str()) != -1)
+	{
+		geometry_drawn = false;
+	}
+}
+
+bool Deferred_Shading::has_geometry() const
+{
+	GLint viewport[4] = {};
+	glGetIntegerv (GL_VIEWPORT, viewport);
+	return is_active() && geometry_drawn
+		   && std::equal (viewport, viewport + 4, geometry_viewport);
+}
+
+void Deferred_Shading::draw_geometry (
+	Cone_Prepass const& prepass,
+	bool                complete)
+{
+	TRACE_SCOPE ("Deferred_Shading::draw_geometry");
+	GLint previous_framebuffer = 0;
+	GLint viewport[4]          = {};
+	glGetIntegerv (GL_DRAW_FRAMEBUFFER_BINDING, &previous_framebuffer);
+	glGetIntegerv (GL_VIEWPORT, viewport);
+
+	// Both passes use the same viewport, so a pixel has the same coordinates
+	//  in the G-buffer as in the frame. The G-buffer only grows, lowering the
+	//  resolution while the camera moves does not reallocate it every frame.
+	g_buffer->resize (
+		std::max (
+			g_buffer->get_width(),
+			static_cast<unsigned int> (viewport[0] + viewport[2])),
+		std::max (
+			g_buffer->get_height(),
+			static_cast<unsigned int> (viewport[1] + viewport[3])));
+	g_buffer->bind();
+	glUseProgram (geometry_program);
+	prepass.bind();
+	screen_vertices.render();
+	prepass.unbind();
+	glUseProgram (0);
+
+	glBindFramebuffer (
+		GL_FRAMEBUFFER,
+		static_cast<GLuint> (previous_framebuffer));
+	std::copy (viewport, viewport + 4, geometry_viewport);
+	geometry_drawn = complete;
+}
+
+void Deferred_Shading::shade()
+{
+	TRACE_SCOPE ("Deferred_Shading::shade");
+	glUseProgram (shading_program);
+	for (unsigned int i = 0; i < attachments; ++i)
+	{
+		glActiveTexture (GL_TEXTURE1 + i);
+		glBindTexture (GL_TEXTURE_2D, g_buffer->get_texture (i));
+	}
+
+	screen_vertices.render();
+
+	for (unsigned int i = 0; i < attachments; ++i)
+	{
+		glActiveTexture (GL_TEXTURE1 + i);
+		glBindTexture (GL_TEXTURE_2D, 0);
+	}
+	glActiveTexture (GL_TEXTURE0);
+	glUseProgram (0);
+}
+
+} // namespace renderer
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "cone_prepass.hpp"
+#include "framebuffer.hpp"
+#include "screen_vertex_array.hpp"
+#include "uniform.hpp"
+
+#include <GL/glew.h>
+
+#include <memory>
+#include <string>
+
+namespace renderer
+{
+
+// Splits a frame into a geometry pass, which writes what the colouring needs
+//  of each pixel to a G-buffer, such as the first hits of the rays or the
+//  iterations of a fractal, and a shading pass which colours the frame from
+//  it. Uniforms the geometry pass never reads, such as colours, materials or
+//  the time, only rerun the shading pass. Fragment shaders opt in with
+//  #ifdef G_BUFFER and DEFERRED_SHADING variants of their main, the shading
+//  variant samples the attachments as g_buffer_0, g_buffer_1 and so on.
+class Deferred_Shading
+{
+public:
+	Deferred_Shading() = default;
+	~Deferred_Shading();
+
+	Deferred_Shading (Deferred_Shading const&) = delete;
+	Deferred_Shading& operator= (Deferred_Shading const&) = delete;
+
+	// Compiles both variants of the shader, returns false for shaders which
+	//  have none.
+	bool load (
+		std::string const& vertex_shader_code,
+		std::string const& fragment_shader_code);
+	void unload();
+
+	void set_enabled (bool enabled);
+	bool is_active() const;
+
+	// Changes to uniforms which the geometry pass reads invalidate the
+	//  G-buffer.
+	void set_uniform (Uniform const& uniform);
+
+	// Whether the G-buffer holds a whole frame for the bound viewport.
+	bool has_geometry() const;
+
+	// Marches the rays of the bound viewport, or of its scissor box, into the
+	//  G-buffer from the distances of the prepass. Complete tells that the
+	//  frame is whole once this pass has finished. Leaves the framebuffer as
+	//  it was.
+	void draw_geometry (Cone_Prepass const& prepass, bool complete);
+
+	// Colours the bound framebuffer from the G-buffer.
+	void shade();
+
+private:
+	static constexpr unsigned int max_attachments = 4;
+
+	GLuint              geometry_program = 0;
+	GLuint              shading_program  = 0;
+	bool                enabled          = true;
+	bool                geometry_drawn   = false;
+	Screen_Vertex_Array screen_vertices;
+
+	// Every attachment is RGBA32F, positions and normals are needed at full
+	//  precision to shade reflected rays from them.
+	std::unique_ptr<Framebuffer> g_buffer;
+	unsigned int                 attachments = 0;
+
+	// The viewport of the frame the G-buffer holds.
+	GLint geometry_viewport[4] = {};
+};
+
+} // namespace renderer
@@ -1,7 +1,9 @@
 #include "shader.hpp"
 
 #include "gl_interface.hpp"
+#include "trace.hpp"
 
+#include <chrono>
 #include <iostream>
 
 namespace renderer
@@ -11,7 +13,11 @@ std::vector<std::unique_ptr<Uniform>> Shader::change_shader (
 	std::filesystem::path const& include_path,
 	std::filesystem::path const& shader_path)
 {
-	valid = false;
+	TRACE_SCOPE ("Shader::change_shader");
+	valid        = false;
+	compile_time = 0.0f;
+	prepass.unload();
+	deferred.unload();
 	if (shader_path.empty())
 	{
 		return {};
@@ -24,9 +30,26 @@ std::vector<std::unique_ptr<Uniform>> Shader::change_shader (
 		return {};
 	}
 
+	using Clock                           = std::chrono::steady_clock;
+	const Clock::time_point compile_start = Clock::now();
+
 	auto [success, new_program_id] = gl::create_program (
 		parser.get_vertex_shader_code(),
 		parser.get_fragment_shader_code());
+	if (success)
+	{
+		prepass.load (
+			parser.get_vertex_shader_code(),
+			parser.get_fragment_shader_code());
+		deferred.load (
+			parser.get_vertex_shader_code(),
+			parser.get_fragment_shader_code());
+	}
+
+	// Compiling and linking block on the driver, so the CPU time covers it.
+	const std::chrono::duration<float, std::milli> compile_duration
+		= Clock::now() - compile_start;
+	compile_time = compile_duration.count();
 
 	if (!success)
 	{
@@ -36,33 +59,180 @@ std::vector<std::unique_ptr<Uniform>> Shader::change_shader (
 	}
 
 	valid = true;
+	restart_frame();
 	glDeleteProgram (program_id);
 	program_id = new_program_id;
+	gl::set_uniform (program_id, Typed_Uniform<int> ("ray_start", {0}));
 
 	return parser.get_uniforms();
 }
 
-void Shader::render()
+bool Shader::render (unsigned int width, unsigned int height)
 {
-	if (valid)
+	if (!valid || frame_budget.count() == 0)
+	{
+		draw();
+		return true;
+	}
+
+	return render_tiles (width, height);
+}
+
+void Shader::draw()
+{
+	TRACE_SCOPE ("Shader::draw");
+	timer.begin_pass();
+	// Only the shading changed, the G-buffer still holds the frame.
+	if (valid && deferred.has_geometry())
 	{
 		glClearColor (0.7f, 0.7f, 0.7f, 1.0f);
 		glClear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-		glUseProgram (program_id);
-		screen_vertices.render();
-		glUseProgram (0);
+		deferred.shade();
+	}
+	else if (valid)
+	{
+		prepass.draw();
+		glClearColor (0.7f, 0.7f, 0.7f, 1.0f);
+		glClear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		draw_rays (true);
 	}
 	else
 	{
 		glClearColor (1.0f, 0.0f, 0.0f, 1.0f);
 		glClear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	}
+	timer.end_pass (true);
+}
 
+std::vector<float> Shader::collect_frame_times (bool wait)
+{
+	return timer.collect_frames (wait);
+}
+
+float Shader::get_compile_time() const
+{
+	return compile_time;
+}
+
+void Shader::set_frame_budget (std::chrono::microseconds budget)
+{
+	frame_budget = budget;
+	restart_frame();
+}
+
+void Shader::set_cone_prepass (bool enabled)
+{
+	prepass.set_enabled (enabled);
+	restart_frame();
+}
+
+unsigned long long Shader::get_skipped_steps() const
+{
+	return prepass.get_skipped_steps();
+}
+
+void Shader::set_deferred_shading (bool enabled)
+{
+	deferred.set_enabled (enabled);
+	restart_frame();
+}
+
+void Shader::restart_frame()
+{
+	timer.discard_frame();
+	next_tile = 0;
+}
+
+bool Shader::render_tiles (unsigned int width, unsigned int height)
+{
+	const unsigned int columns    = (width + tile_size - 1) / tile_size;
+	const unsigned int rows       = (height + tile_size - 1) / tile_size;
+	const unsigned int tile_count = columns * rows;
+	if (next_tile >= tile_count)
+	{
+		return true;
 	}
+
+	// Tiles of a restarted frame are drawn over the previous one, unless the
+	//  previous one no longer matches the target.
+	if (next_tile == 0 && (width != tiled_width || height != tiled_height))
+	{
+		glClearColor (0.7f, 0.7f, 0.7f, 1.0f);
+		glClear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		tiled_width  = width;
+		tiled_height = height;
+	}
+
+	using Clock                         = std::chrono::steady_clock;
+	const Clock::time_point frame_start = Clock::now();
+
+	TRACE_SCOPE ("Shader::render_tiles");
+	timer.begin_pass();
+
+	// Only the shading changed since the last whole frame, colouring it
+	//  again is cheap enough to do at once.
+	if (next_tile == 0 && deferred.has_geometry())
+	{
+		deferred.shade();
+		next_tile = tile_count;
+		timer.end_pass (true);
+		return true;
+	}
+
+	// The distances are marched once per frame, later calls reuse them.
+	if (next_tile == 0)
+	{
+		prepass.draw();
+	}
+
+	glEnable (GL_SCISSOR_TEST);
+	while (next_tile < tile_count)
+	{
+		const unsigned int column = next_tile % columns;
+		const unsigned int row    = next_tile / columns;
+		glScissor (
+			static_cast<GLint> (column * tile_size),
+			static_cast<GLint> (row * tile_size),
+			tile_size,
+			tile_size);
+		draw_rays (next_tile + 1 == tile_count);
+		++next_tile;
+
+		// Waiting for each tile keeps a single submission from running past
+		//  the budget, which is what stalls the compositor or the watchdog.
+		glFinish();
+		if (Clock::now() - frame_start >= frame_budget)
+		{
+			break;
+		}
+	}
+	glDisable (GL_SCISSOR_TEST);
+
+	const bool frame_complete = next_tile >= tile_count;
+	timer.end_pass (frame_complete);
+	return frame_complete;
+}
+
+void Shader::draw_rays (bool complete)
+{
+	if (deferred.is_active())
+	{
+		deferred.draw_geometry (prepass, complete);
+		deferred.shade();
+		return;
+	}
+
+	glUseProgram (program_id);
+	prepass.bind();
+	screen_vertices.render();
+	prepass.unbind();
+	glUseProgram (0);
 }
 
 void Shader::set_uniform (Uniform const& uniform)
 {
+	TRACE_SCOPE ("Shader::set_uniform");
+	restart_frame();
 	if (!valid)
 	{
 		return;
@@ -71,6 +241,8 @@ void Shader::set_uniform (Uniform const& uniform)
 	try
 	{
 		gl::set_uniform (program_id, uniform);
+		prepass.set_uniform (uniform);
+		deferred.set_uniform (uniform);
 	}
 	catch (std::bad_cast const& /* e */)
 	{
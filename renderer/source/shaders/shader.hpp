@@ -1,11 +1,15 @@
 #pragma once
 
+#include "cone_prepass.hpp"
+#include "deferred_shading.hpp"
+#include "gpu_timer.hpp"
 #include "parser.hpp"
 #include "screen_vertex_array.hpp"
 #include "uniform.hpp"
 
 #include <GL/glew.h>
 
+#include <chrono>
 #include <filesystem>
 #include <map>
 #include <memory>
@@ -18,18 +22,53 @@ namespace renderer
 class Shader
 {
 public:
-	void render();
+	// Draws the tiles of the current frame which fit in the frame budget,
+	//  returns true once every tile of the frame has been drawn.
+	bool render (unsigned int width, unsigned int height);
+	// Draws the whole frame into the current viewport regardless of budget.
+	void draw();
 	void set_uniform (Uniform const& uniform);
 
+	// A zero budget draws the whole frame at once.
+	void set_frame_budget (std::chrono::microseconds budget);
+	void restart_frame();
+
+	// Only shaders with a CONE_PREPASS variant use the prepass.
+	void               set_cone_prepass (bool enabled);
+	unsigned long long get_skipped_steps() const;
+
+	// Only shaders with G_BUFFER and DEFERRED_SHADING variants are shaded
+	//  deferred.
+	void set_deferred_shading (bool enabled);
+
 	std::vector<std::unique_ptr<Uniform>> change_shader (
 		std::filesystem::path const& include_path,
 		std::filesystem::path const& shader_path);
 
+	// GPU milliseconds of the frames drawn since the last call whose results
+	//  are available, or of all of them when waiting.
+	std::vector<float> collect_frame_times (bool wait = false);
+	float              get_compile_time() const;
+
 private:
+	static constexpr unsigned int tile_size = 128;
+
 	bool valid = false;
 
 	GLuint              program_id = 0;
 	Screen_Vertex_Array screen_vertices;
+	gl::Gpu_Timer       timer;
+	Cone_Prepass        prepass;
+	Deferred_Shading    deferred;
+	float               compile_time = 0.0f;
+
+	std::chrono::microseconds frame_budget{0};
+	unsigned int              next_tile    = 0;
+	unsigned int              tiled_width  = 0;
+	unsigned int              tiled_height = 0;
+
+	bool render_tiles (unsigned int width, unsigned int height);
+	void draw_rays (bool complete);
 
 	void print_parser_errors (preprocessor::Parser const& parser);
 };
@@ -0,0 +1,414 @@
+#include "tile_cache.hpp"
+
+#include "shader.hpp"
+#include "trace.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <functional>
+#include <tuple>
+
+namespace renderer
+{
+
+namespace
+{
+void combine_hash (std::size_t& hash, std::size_t value)
+{
+	hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+}
+
+template <typename T>
+bool hash_values (Uniform const& uniform, std::size_t& hash)
+{
+	const auto typed = dynamic_cast<const Typed_Uniform<T>*> (&uniform);
+	if (typed == nullptr)
+	{
+		return false;
+	}
+
+	for (T const value : typed->get_values())
+	{
+		combine_hash (hash, std::hash<T>{}(value));
+	}
+	return true;
+}
+} // namespace
+
+bool Tile_Cache::Tile_Key::operator< (Tile_Key const& other) const
+{
+	return std::tie (level, x, y, state)
+		   < std::tie (other.level, other.x, other.y, other.state);
+}
+
+Tile_Cache::Tile_Cache (Shader& p_shader) : shader (p_shader) {}
+
+void Tile_Cache::set_shader (
+	std::string const&                           name,
+	std::vector<std::unique_ptr<Uniform>> const& uniforms)
+{
+	shader_name            = name;
+	active                 = false;
+	camera_position_low[0] = 0.0f;
+	camera_position_low[1] = 0.0f;
+	uniform_hashes.clear();
+	for (std::unique_ptr<Uniform> const& uniform : uniforms)
+	{
+		// The viewer tells 2D shaders apart the same way.
+		const auto position
+			= dynamic_cast<const Typed_Uniform<float>*> (uniform.get());
+		if (uniform->get_name() == "camera.position" && position != nullptr
+			&& position->get_values().size() == 2)
+		{
+			active = true;
+		}
+		set_uniform (*uniform);
+	}
+}
+
+void Tile_Cache::set_uniform (Uniform const& uniform)
+{
+	const std::string name = uniform.get_name();
+	const auto        values
+		= dynamic_cast<const Typed_Uniform<float>*> (&uniform);
+	if (name == "camera.position" || name == "camera.position_low")
+	{
+		float* position = name == "camera.position" ? camera_position
+													: camera_position_low;
+		if (values != nullptr && values->get_values().size() == 2)
+		{
+			position[0] = values->get_values()[0];
+			position[1] = values->get_values()[1];
+		}
+		return;
+	}
+	if (name == "camera.zoom")
+	{
+		if (values != nullptr && values->get_values().size() == 1)
+		{
+			camera_zoom = values->get_values()[0];
+		}
+		return;
+	}
+
+	// The resolution and the tile region are set for every tile.
+	if (name.rfind ("v_globals.", 0) == 0)
+	{
+		return;
+	}
+
+	std::size_t hash = std::hash<std::string>{}(name);
+	hash_values<bool> (uniform, hash) || hash_values<int> (uniform, hash)
+		|| hash_values<unsigned int> (uniform, hash)
+		|| hash_values<float> (uniform, hash)
+		|| hash_values<double> (uniform, hash);
+	uniform_hashes[name] = hash;
+}
+
+bool Tile_Cache::is_active() const
+{
+	return active && memory_budget >= tile_bytes;
+}
+
+void Tile_Cache::set_frame_budget (std::chrono::microseconds budget)
+{
+	frame_budget = budget;
+}
+
+void Tile_Cache::set_memory_budget (std::size_t bytes)
+{
+	memory_budget = bytes;
+	evict();
+}
+
+bool Tile_Cache::render (unsigned int width, unsigned int height)
+{
+	TRACE_SCOPE ("Tile_Cache::render");
+	using Clock                         = std::chrono::steady_clock;
+	const Clock::time_point frame_start = Clock::now();
+
+	View view;
+	view.pixel
+		= 2.0 * std::clamp (1.0f - camera_zoom, min_zoom, 2.0f)
+		  / screen_in_pixels_2d;
+	const double extent = std::max (
+		std::abs (camera_position[0]),
+		std::abs (camera_position[1]));
+	if (extent * FLT_EPSILON > 0.25 * view.pixel)
+	{
+		return false;
+	}
+
+	++frame;
+	GLint target = 0;
+	glGetIntegerv (GL_DRAW_FRAMEBUFFER_BINDING, &target);
+	glGetIntegerv (GL_VIEWPORT, view.viewport);
+	view.target = static_cast<GLuint> (target);
+	view.left   = double{camera_position[0]} + camera_position_low[0]
+				  - 0.5 * width * view.pixel;
+	view.bottom = double{camera_position[1]} + camera_position_low[1]
+				  - 0.5 * height * view.pixel;
+	view.right  = view.left + width * view.pixel;
+	view.top    = view.bottom + height * view.pixel;
+
+	// The coarsest level whose pixels are no larger than those of the view.
+	const int level = std::max (
+		0,
+		static_cast<int> (
+			std::ceil (std::log2 (level_pixel (0) / view.pixel) - 1e-3)));
+	const std::size_t state = state_hash();
+
+	glClearColor (0.7f, 0.7f, 0.7f, 1.0f);
+	glClear (GL_COLOR_BUFFER_BIT);
+
+	// Cached tiles of the neighbouring levels stand in for missing ones, the
+	//  finer levels are drawn over the coarser.
+	for (int fallback = fallbacks; fallback > 0; --fallback)
+	{
+		draw_level (level - fallback, state, view);
+	}
+	draw_level (level + 1, state, view);
+
+	bool rendered      = false;
+	bool within_budget = true;
+	for (Tile_Key const& key : tiles_in_view (level, state, view, 0))
+	{
+		Tile* tile = find (key);
+		if (tile == nullptr && within_budget)
+		{
+			render_tile (key);
+			tile     = find (key);
+			rendered = true;
+
+			// As for tiled frames, waiting for each tile keeps the frame
+			//  from running past the budget.
+			glFinish();
+			within_budget = frame_budget.count() == 0
+							|| Clock::now() - frame_start < frame_budget;
+		}
+		if (tile != nullptr)
+		{
+			draw_tile (key, *tile, view);
+		}
+	}
+
+	// The view is whole, spend the rest of the budget on the tiles the
+	//  camera is likely to reach next.
+	if (within_budget && frame_budget.count() > 0)
+	{
+		for (Tile_Key const& key : tiles_in_view (level, state, view, prefetch))
+		{
+			if (Clock::now() - frame_start >= frame_budget)
+			{
+				break;
+			}
+			if (find (key) == nullptr)
+			{
+				render_tile (key);
+				rendered = true;
+				glFinish();
+			}
+		}
+	}
+
+	if (rendered)
+	{
+		restore_uniforms (width, height);
+	}
+	glBindFramebuffer (GL_FRAMEBUFFER, view.target);
+	glViewport (
+		view.viewport[0],
+		view.viewport[1],
+		view.viewport[2],
+		view.viewport[3]);
+	evict();
+	return true;
+}
+
+std::size_t Tile_Cache::state_hash() const
+{
+	std::size_t hash = std::hash<std::string>{}(shader_name);
+	for (auto const& [name, value] : uniform_hashes)
+	{
+		combine_hash (hash, value);
+	}
+	return hash;
+}
+
+float Tile_Cache::level_zoom (int level) const
+{
+	return 1.0f - 2.0f * std::ldexp (1.0f, -level);
+}
+
+double Tile_Cache::level_pixel (int level) const
+{
+	return 2.0 * std::clamp (1.0f - level_zoom (level), min_zoom, 2.0f)
+		   / screen_in_pixels_2d;
+}
+
+void Tile_Cache::tile_centre (Tile_Key const& key, float centre[2]) const
+{
+	const double extent = tile_size * level_pixel (key.level);
+	centre[0]           = static_cast<float> ((key.x + 0.5) * extent);
+	centre[1]           = static_cast<float> ((key.y + 0.5) * extent);
+}
+
+std::vector<Tile_Cache::Tile_Key> Tile_Cache::tiles_in_view (
+	int         level,
+	std::size_t state,
+	View const& view,
+	int         margin) const
+{
+	const double extent = tile_size * level_pixel (level);
+	const auto   first_x
+		= static_cast<long long> (std::floor (view.left / extent)) - margin;
+	const auto last_x
+		= static_cast<long long> (std::floor (view.right / extent)) + margin;
+	const auto first_y
+		= static_cast<long long> (std::floor (view.bottom / extent)) - margin;
+	const auto last_y
+		= static_cast<long long> (std::floor (view.top / extent)) + margin;
+
+	std::vector<Tile_Key> keys;
+	for (long long y = first_y; y <= last_y; ++y)
+	{
+		for (long long x = first_x; x <= last_x; ++x)
+		{
+			keys.push_back ({level, x, y, state});
+		}
+	}
+
+	const double centre_x = 0.5 * (view.left + view.right) / extent - 0.5;
+	const double centre_y = 0.5 * (view.bottom + view.top) / extent - 0.5;
+	auto         distance = [&] (Tile_Key const& key)
+	{
+		return std::hypot (key.x - centre_x, key.y - centre_y);
+	};
+	std::stable_sort (
+		keys.begin(),
+		keys.end(),
+		[&] (Tile_Key const& a, Tile_Key const& b)
+		{ return distance (a) < distance (b); });
+	return keys;
+}
+
+Tile_Cache::Tile* Tile_Cache::find (Tile_Key const& key)
+{
+	auto tile = tiles.find (key);
+	if (tile == tiles.end())
+	{
+		return nullptr;
+	}
+
+	recency.splice (recency.begin(), recency, tile->second.recency);
+	tile->second.frame = frame;
+	return &tile->second;
+}
+
+void Tile_Cache::render_tile (Tile_Key const& key)
+{
+	TRACE_SCOPE ("Tile_Cache::render_tile");
+	float centre[2];
+	tile_centre (key, centre);
+	shader.set_uniform (Typed_Uniform<unsigned int> (
+		"v_globals.resolution",
+		{tile_size, tile_size}));
+	shader.set_uniform (
+		Typed_Uniform<float> ("camera.zoom", {level_zoom (key.level)}));
+	shader.set_uniform (
+		Typed_Uniform<float> ("camera.position", {centre[0], centre[1]}));
+	shader.set_uniform (
+		Typed_Uniform<float> ("camera.position_low", {0.0f, 0.0f}));
+
+	auto target = std::make_unique<Framebuffer>();
+	target->resize (tile_size, tile_size);
+	target->bind();
+	glViewport (0, 0, tile_size, tile_size);
+	shader.draw();
+
+	recency.push_front (key);
+	tiles[key] = Tile{std::move (target), recency.begin(), frame};
+}
+
+void Tile_Cache::restore_uniforms (unsigned int width, unsigned int height)
+{
+	shader.set_uniform (
+		Typed_Uniform<unsigned int> ("v_globals.resolution", {width, height}));
+	shader.set_uniform (Typed_Uniform<float> ("camera.zoom", {camera_zoom}));
+	shader.set_uniform (Typed_Uniform<float> (
+		"camera.position",
+		{camera_position[0], camera_position[1]}));
+	shader.set_uniform (Typed_Uniform<float> (
+		"camera.position_low",
+		{camera_position_low[0], camera_position_low[1]}));
+}
+
+void Tile_Cache::draw_tile (
+	Tile_Key const& key,
+	Tile const&     tile,
+	View const&     view)
+{
+	float centre[2];
+	tile_centre (key, centre);
+	const double half = 0.5 * tile_size * level_pixel (key.level);
+
+	// Pixel edges of the frame, from plane coordinates.
+	auto column = [&] (double x)
+	{
+		return static_cast<GLint> (std::lround ((x - view.left) / view.pixel))
+			   + view.viewport[0];
+	};
+	auto row = [&] (double y)
+	{
+		return static_cast<GLint> (std::lround ((y - view.bottom) / view.pixel))
+			   + view.viewport[1];
+	};
+
+	glBindFramebuffer (GL_READ_FRAMEBUFFER, tile.target->get_id());
+	glBindFramebuffer (GL_DRAW_FRAMEBUFFER, view.target);
+	glBlitFramebuffer (
+		0,
+		0,
+		tile_size,
+		tile_size,
+		column (centre[0] - half),
+		row (centre[1] - half),
+		column (centre[0] + half),
+		row (centre[1] + half),
+		GL_COLOR_BUFFER_BIT,
+		GL_LINEAR);
+}
+
+void Tile_Cache::draw_level (int level, std::size_t state, View const& view)
+{
+	if (level < 0)
+	{
+		return;
+	}
+
+	for (Tile_Key const& key : tiles_in_view (level, state, view, 0))
+	{
+		if (Tile* tile = find (key))
+		{
+			draw_tile (key, *tile, view);
+		}
+	}
+}
+
+void Tile_Cache::evict()
+{
+	// Tiles of the current frame are kept even beyond the budget.
+	while (!recency.empty() && tiles.size() * tile_bytes > memory_budget)
+	{
+		auto oldest = tiles.find (recency.back());
+		if (oldest->second.frame == frame)
+		{
+			break;
+		}
+		tiles.erase (oldest);
+		recency.pop_back();
+	}
+}
+
+} // namespace renderer
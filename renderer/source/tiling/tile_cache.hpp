@@ -0,0 +1,139 @@
+#pragma once
+
+#include "framebuffer.hpp"
+#include "uniform.hpp"
+
+#include <GL/glew.h>
+
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace renderer
+{
+
+class Shader;
+
+// Caches square tiles of the complex plane, like the tiles of a map viewer.
+//  Tiles are rendered at zoom levels a power of two apart and keyed by their
+//  level, their position and a hash of the shader and its uniforms other
+//  than the camera. Frames are composed from the cached tiles, only missing
+//  tiles are rendered, nearest to the centre first and within the frame
+//  budget, while cached tiles of the neighbouring levels stand in for the
+//  rest. Once the view is complete the tiles around it are rendered ahead.
+//  The least recently used tiles are evicted beyond the memory budget.
+class Tile_Cache
+{
+public:
+	explicit Tile_Cache (Shader& shader);
+
+	// Shaders with a two dimensional camera position draw the complex plane,
+	//  the cache is only active for them and with a memory budget of at least
+	//  one tile.
+	void set_shader (
+		std::string const&                           name,
+		std::vector<std::unique_ptr<Uniform>> const& uniforms);
+	void set_uniform (Uniform const& uniform);
+	bool is_active() const;
+
+	// A zero frame budget renders every missing tile of the view at once,
+	//  without rendering ahead.
+	void set_frame_budget (std::chrono::microseconds budget);
+	void set_memory_budget (std::size_t bytes);
+
+	// Composes the frame in the bound framebuffer and viewport. Returns false
+	//  without drawing once the tiles are too small to be placed at the
+	//  precision of a float camera position, the caller draws the frame.
+	bool render (unsigned int width, unsigned int height);
+
+private:
+	// As in constants.glsl.
+	static constexpr double screen_in_pixels_2d = 512.0;
+	static constexpr float  min_zoom            = 1e-6f;
+
+	static constexpr unsigned int tile_size  = 128;
+	static constexpr std::size_t  tile_bytes = tile_size * tile_size * 4;
+	static constexpr int          prefetch   = 1;
+	static constexpr int          fallbacks  = 2;
+
+	struct Tile_Key
+	{
+		int         level;
+		long long   x;
+		long long   y;
+		std::size_t state;
+
+		bool operator< (Tile_Key const& other) const;
+	};
+
+	struct Tile
+	{
+		std::unique_ptr<Framebuffer>  target;
+		std::list<Tile_Key>::iterator recency;
+		unsigned long long            frame = 0;
+	};
+
+	// Where the frame lies on the plane and where it is drawn to.
+	struct View
+	{
+		double pixel;
+		double left;
+		double bottom;
+		double right;
+		double top;
+		GLuint target;
+		GLint  viewport[4];
+	};
+
+	Shader& shader;
+
+	bool        active = false;
+	std::string shader_name;
+	float       camera_position[2] = {0.0f, 0.0f};
+	float       camera_zoom        = 0.0f;
+
+	// The double-float remainder of the position, tiles are drawn without
+	//  it since they are only cached while a float places them.
+	float camera_position_low[2] = {0.0f, 0.0f};
+
+	// Hashes of the values of every other uniform, by name.
+	std::map<std::string, std::size_t> uniform_hashes;
+
+	std::chrono::microseconds frame_budget{0};
+	std::size_t               memory_budget = std::size_t{256} << 20;
+
+	std::map<Tile_Key, Tile> tiles;
+	std::list<Tile_Key>      recency;
+	unsigned long long       frame = 0;
+
+	std::size_t state_hash() const;
+
+	// Zoom uniform of a level and the size of its pixels on the plane, the
+	//  size is computed the way the vertex shader does.
+	float  level_zoom (int level) const;
+	double level_pixel (int level) const;
+
+	// The centre of a tile at float precision, as the camera sees it.
+	void tile_centre (Tile_Key const& key, float centre[2]) const;
+
+	// Tiles of a level covering the view and the margin around it, nearest
+	//  to the centre of the view first.
+	std::vector<Tile_Key> tiles_in_view (
+		int         level,
+		std::size_t state,
+		View const& view,
+		int         margin) const;
+
+	Tile* find (Tile_Key const& key);
+	void  render_tile (Tile_Key const& key);
+	void  restore_uniforms (unsigned int width, unsigned int height);
+	void  draw_tile (Tile_Key const& key, Tile const& tile, View const& view);
+	void  draw_level (int level, std::size_t state, View const& view);
+	void  evict();
+};
+
+} // namespace renderer
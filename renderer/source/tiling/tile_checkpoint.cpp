@@ -0,0 +1,68 @@
+#include "tile_checkpoint.hpp"
+
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace renderer
+{
+
+bool Tile_Checkpoint::matches (Tile_Checkpoint const& other) const
+{
+	return job == other.job && width == other.width && height == other.height
+		   && tile_size == other.tile_size;
+}
+
+fs::path checkpoint_path (fs::path const& output)
+{
+	fs::path path = output;
+	path += ".checkpoint";
+	return path;
+}
+
+Tile_Checkpoint load_checkpoint (fs::path const& path)
+{
+	Tile_Checkpoint checkpoint;
+
+	std::ifstream file (path);
+	if (!file.is_open())
+	{
+		return checkpoint;
+	}
+
+	std::getline (file, checkpoint.job);
+	file >> checkpoint.width >> checkpoint.height >> checkpoint.tile_size
+		>> checkpoint.state.rows >> checkpoint.state.bytes
+		>> checkpoint.state.checksum;
+
+	if (!file)
+	{
+		return Tile_Checkpoint{};
+	}
+	return checkpoint;
+}
+
+bool save_checkpoint (fs::path const& path, Tile_Checkpoint const& checkpoint)
+{
+	fs::path temporary = path;
+	temporary += ".tmp";
+
+	{
+		std::ofstream file (temporary, std::ios::trunc);
+		file << checkpoint.job << "\n"
+			 << checkpoint.width << " " << checkpoint.height << " "
+			 << checkpoint.tile_size << "\n"
+			 << checkpoint.state.rows << " " << checkpoint.state.bytes << " "
+			 << checkpoint.state.checksum << "\n";
+		if (!file)
+		{
+			return false;
+		}
+	}
+
+	std::error_code error;
+	fs::rename (temporary, path, error);
+	return !error;
+}
+
+} // namespace renderer
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "image_writer.hpp"
+
+#include <filesystem>
+#include <string>
+
+namespace renderer
+{
+
+// Records how many rows of a tiled render reached the image file, so that
+//  an interrupted render can continue after them.
+struct Tile_Checkpoint
+{
+	std::string      job;
+	unsigned int     width     = 0;
+	unsigned int     height    = 0;
+	unsigned int     tile_size = 0;
+	io::Writer_State state;
+
+	bool matches (Tile_Checkpoint const& other) const;
+};
+
+std::filesystem::path checkpoint_path (std::filesystem::path const& output);
+
+// Returns a checkpoint with no rows if none could be read.
+Tile_Checkpoint load_checkpoint (std::filesystem::path const& path);
+
+// Replaces the previous checkpoint in a single rename, so that a crash never
+//  leaves half of one behind.
+bool save_checkpoint (
+	std::filesystem::path const& path,
+	Tile_Checkpoint const&       checkpoint);
+
+} // namespace renderer
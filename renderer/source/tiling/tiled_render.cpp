@@ -0,0 +1,165 @@
+#include "tiled_render.hpp"
+
+#include "shader.hpp"
+#include "tile_checkpoint.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace renderer
+{
+
+Tiled_Render::Tiled_Render (
+	Shader&      p_shader,
+	unsigned int p_width,
+	unsigned int p_height,
+	unsigned int p_tile_size)
+	: shader (p_shader)
+	, width (p_width)
+	, height (p_height)
+	, tile_size (p_tile_size)
+	, tile_pixels (size_t{p_tile_size} * p_tile_size * 4)
+	, row_pixels (size_t{p_width} * p_tile_size * 3)
+{
+	tile_target.resize (tile_size, tile_size);
+}
+
+bool Tiled_Render::run (
+	fs::path const&    output,
+	std::string const& job,
+	Progress const&    progress)
+{
+	const fs::path  checkpoint_file = checkpoint_path (output);
+	Tile_Checkpoint checkpoint{job, width, height, tile_size, {}};
+
+	const Tile_Checkpoint previous = load_checkpoint (checkpoint_file);
+	if (previous.matches (checkpoint) && fs::exists (output))
+	{
+		checkpoint.state = previous.state;
+	}
+
+	std::unique_ptr<io::Image_Writer> writer = io::create_image_writer (
+		output,
+		width,
+		height,
+		checkpoint.state);
+	if (writer == nullptr || !writer->is_valid())
+	{
+		std::cerr << "Can not write " << output.string() << "\n";
+		return false;
+	}
+
+	const unsigned int tile_rows = (height + tile_size - 1) / tile_size;
+	for (unsigned int tile_row = checkpoint.state.rows / tile_size;
+		 tile_row < tile_rows;
+		 ++tile_row)
+	{
+		render_row (tile_row);
+
+		const unsigned int rows
+			= std::min (tile_size, height - tile_row * tile_size);
+		writer->write_rows (row_pixels.data(), rows);
+
+		checkpoint.state = writer->get_state();
+		const bool saved = save_checkpoint (checkpoint_file, checkpoint);
+		if (!writer->is_valid() || !saved)
+		{
+			std::cerr << "Failed to write " << output.string() << "\n";
+			return false;
+		}
+
+		if (progress)
+		{
+			progress (tile_row + 1, tile_rows);
+		}
+	}
+	set_tile_region (0.0f, 0.0f, 1.0f, 1.0f);
+
+	writer->finish();
+	if (!writer->is_valid())
+	{
+		return false;
+	}
+
+	std::error_code error;
+	fs::remove (checkpoint_file, error);
+	return true;
+}
+
+void Tiled_Render::render_row (unsigned int tile_row)
+{
+	// Rows of the image start at the top, while framebuffer rows start at
+	//  the bottom of the frame.
+	const unsigned int top         = tile_row * tile_size;
+	const unsigned int tile_height = std::min (tile_size, height - top);
+	const unsigned int y           = height - top - tile_height;
+
+	for (unsigned int x = 0; x < width; x += tile_size)
+	{
+		const unsigned int tile_width = std::min (tile_size, width - x);
+		render_tile (x, y, tile_width, tile_height);
+
+		for (unsigned int row = 0; row < tile_height; ++row)
+		{
+			std::uint8_t const* source
+				= &tile_pixels[size_t{tile_height - 1 - row} * tile_width * 4];
+			std::uint8_t* destination
+				= &row_pixels[(size_t{row} * width + x) * 3];
+			for (unsigned int column = 0; column < tile_width; ++column)
+			{
+				destination[column * 3 + 0] = source[column * 4 + 0];
+				destination[column * 3 + 1] = source[column * 4 + 1];
+				destination[column * 3 + 2] = source[column * 4 + 2];
+			}
+		}
+	}
+}
+
+void Tiled_Render::render_tile (
+	unsigned int x,
+	unsigned int y,
+	unsigned int tile_width,
+	unsigned int tile_height)
+{
+	// Map the screen quad onto the part of the frame covered by the tile,
+	//  in normalised device coordinates of the whole frame.
+	const float scale_x  = static_cast<float> (tile_width) / width;
+	const float scale_y  = static_cast<float> (tile_height) / height;
+	const float offset_x = (2.0f * x + tile_width) / width - 1.0f;
+	const float offset_y = (2.0f * y + tile_height) / height - 1.0f;
+	set_tile_region (offset_x, offset_y, scale_x, scale_y);
+
+	tile_target.bind();
+	glViewport (
+		0,
+		0,
+		static_cast<GLsizei> (tile_width),
+		static_cast<GLsizei> (tile_height));
+	shader.draw();
+
+	glPixelStorei (GL_PACK_ALIGNMENT, 1);
+	glReadPixels (
+		0,
+		0,
+		static_cast<GLsizei> (tile_width),
+		static_cast<GLsizei> (tile_height),
+		GL_RGBA,
+		GL_UNSIGNED_BYTE,
+		tile_pixels.data());
+}
+
+void Tiled_Render::set_tile_region (
+	float offset_x,
+	float offset_y,
+	float scale_x,
+	float scale_y)
+{
+	shader.set_uniform (
+		Typed_Uniform<float> ("v_globals.tile_offset", {offset_x, offset_y}));
+	shader.set_uniform (
+		Typed_Uniform<float> ("v_globals.tile_scale", {scale_x, scale_y}));
+}
+
+} // namespace renderer
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "framebuffer.hpp"
+#include "image_writer.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace renderer
+{
+
+class Shader;
+
+// Renders a frame larger than any framebuffer one tile at a time. Each tile
+//  is drawn with the vertex globals narrowed to its part of the frame, and
+//  every finished row of tiles is streamed to the image file so that memory
+//  use stays bounded by a single row of tiles.
+class Tiled_Render
+{
+public:
+	using Progress = std::function<void (unsigned int, unsigned int)>;
+
+	Tiled_Render (
+		Shader&      shader,
+		unsigned int width,
+		unsigned int height,
+		unsigned int tile_size);
+
+	bool run (
+		std::filesystem::path const& output,
+		std::string const&           job,
+		Progress const&              progress);
+
+private:
+	Shader&            shader;
+	const unsigned int width;
+	const unsigned int height;
+	const unsigned int tile_size;
+
+	Framebuffer               tile_target;
+	std::vector<std::uint8_t> tile_pixels;
+	std::vector<std::uint8_t> row_pixels;
+
+	void render_row (unsigned int tile_row);
+	void render_tile (
+		unsigned int x,
+		unsigned int y,
+		unsigned int tile_width,
+		unsigned int tile_height);
+	void set_tile_region (
+		float offset_x,
+		float offset_y,
+		float scale_x,
+		float scale_y);
+};
+
+} // namespace renderer
@@ -0,0 +1,275 @@
+#include "image_writer.hpp"
+
+#include <renderer/image.hpp>
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+const size_t max_stored_block_size = 65535;
+
+std::array<std::uint32_t, 256> create_crc_table()
+{
+	std::array<std::uint32_t, 256> table{};
+	for (std::uint32_t n = 0; n < table.size(); ++n)
+	{
+		std::uint32_t c = n;
+		for (int k = 0; k < 8; ++k)
+		{
+			c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+		}
+		table[n] = c;
+	}
+	return table;
+}
+
+std::uint32_t crc (std::string const& data)
+{
+	static const std::array<std::uint32_t, 256> table = create_crc_table();
+
+	std::uint32_t c = 0xffffffffu;
+	for (char const character : data)
+	{
+		const auto byte = static_cast<std::uint8_t> (character);
+		c               = table[(c ^ byte) & 0xff] ^ (c >> 8);
+	}
+	return c ^ 0xffffffffu;
+}
+
+void append_big_endian (std::string& data, std::uint32_t value)
+{
+	data += static_cast<char> ((value >> 24) & 0xff);
+	data += static_cast<char> ((value >> 16) & 0xff);
+	data += static_cast<char> ((value >> 8) & 0xff);
+	data += static_cast<char> (value & 0xff);
+}
+
+void append_stored_block (
+	std::string&        data,
+	std::uint8_t const* bytes,
+	size_t              size,
+	bool                final_block)
+{
+	const auto length = static_cast<std::uint16_t> (size);
+	data += static_cast<char> (final_block ? 1 : 0);
+	data += static_cast<char> (length & 0xff);
+	data += static_cast<char> (length >> 8);
+	data += static_cast<char> (~length & 0xff);
+	data += static_cast<char> ((~length >> 8) & 0xff);
+	data.append (reinterpret_cast<char const*> (bytes), size);
+}
+
+} // namespace
+
+namespace io
+{
+
+Image_Writer::Image_Writer (
+	fs::path const&     path,
+	unsigned int        p_width,
+	unsigned int        p_height,
+	Writer_State const& resume)
+	: width (p_width)
+	, height (p_height)
+	, rows_written (resume.rows)
+{
+	if (resume.rows == 0)
+	{
+		file.open (path, std::ios::binary | std::ios::trunc);
+		return;
+	}
+
+	std::error_code error;
+	fs::resize_file (path, resume.bytes, error);
+	if (error)
+	{
+		std::cerr << "Can not resume writing " << path.string() << ": "
+				  << error.message() << "\n";
+		file.setstate (std::ios::failbit);
+		return;
+	}
+	file.open (path, std::ios::binary | std::ios::app);
+}
+
+bool Image_Writer::is_valid() const
+{
+	return file.good();
+}
+
+Writer_State Image_Writer::get_state()
+{
+	file.flush();
+	return {rows_written, static_cast<std::uint64_t> (file.tellp()), 1};
+}
+
+Ppm_Writer::Ppm_Writer (
+	fs::path const&     path,
+	unsigned int        p_width,
+	unsigned int        p_height,
+	Writer_State const& resume)
+	: Image_Writer (path, p_width, p_height, resume)
+{
+	if (resume.rows == 0)
+	{
+		file << "P6\n" << width << " " << height << "\n255\n";
+	}
+}
+
+void Ppm_Writer::write_rows (std::uint8_t const* rows, unsigned int count)
+{
+	file.write (
+		reinterpret_cast<char const*> (rows),
+		static_cast<std::streamsize> (size_t{width} * 3 * count));
+	rows_written += count;
+}
+
+void Ppm_Writer::finish()
+{
+	file.flush();
+}
+
+Png_Writer::Png_Writer (
+	fs::path const&     path,
+	unsigned int        p_width,
+	unsigned int        p_height,
+	Writer_State const& resume)
+	: Image_Writer (path, p_width, p_height, resume)
+	, adler_a (resume.checksum & 0xffff)
+	, adler_b (resume.checksum >> 16)
+{
+	if (resume.rows != 0)
+	{
+		return;
+	}
+
+	const char signature[] = {
+		'\x89', 'P', 'N', 'G', '\r', '\n', '\x1a', '\n'};
+	file.write (signature, sizeof (signature));
+
+	std::string header;
+	append_big_endian (header, width);
+	append_big_endian (header, height);
+	header += '\x08'; // Bit depth
+	header += '\x02'; // Truecolour
+	header += '\x00'; // Deflate compression
+	header += '\x00'; // Adaptive filtering
+	header += '\x00'; // No interlacing
+	write_chunk ("IHDR", header);
+
+	// The zlib stream header, without a preset dictionary.
+	write_chunk ("IDAT", std::string ("\x78\x01", 2));
+}
+
+void Png_Writer::write_rows (std::uint8_t const* rows, unsigned int count)
+{
+	const size_t row_size = size_t{width} * 3;
+
+	// One chunk per scanline keeps the extra memory to a single row. Every
+	//  scanline is prefixed by its filter type, none in this case.
+	std::vector<std::uint8_t> scanline (row_size + 1, 0);
+	for (unsigned int row = 0; row < count; ++row)
+	{
+		std::copy (
+			rows + row * row_size,
+			rows + (row + 1) * row_size,
+			scanline.begin() + 1);
+		update_adler (scanline.data(), scanline.size());
+
+		std::string data;
+		for (size_t offset = 0; offset < scanline.size();
+			 offset += max_stored_block_size)
+		{
+			const size_t size
+				= std::min (max_stored_block_size, scanline.size() - offset);
+			append_stored_block (data, scanline.data() + offset, size, false);
+		}
+		write_chunk ("IDAT", data);
+	}
+	rows_written += count;
+}
+
+void Png_Writer::finish()
+{
+	std::string data;
+	append_stored_block (data, nullptr, 0, true);
+	append_big_endian (data, (adler_b << 16) | adler_a);
+	write_chunk ("IDAT", data);
+	write_chunk ("IEND", "");
+	file.flush();
+}
+
+Writer_State Png_Writer::get_state()
+{
+	Writer_State state = Image_Writer::get_state();
+	state.checksum     = (adler_b << 16) | adler_a;
+	return state;
+}
+
+void Png_Writer::write_chunk (std::string const& type, std::string const& data)
+{
+	std::string length;
+	append_big_endian (length, static_cast<std::uint32_t> (data.size()));
+
+	std::string checksum;
+	append_big_endian (checksum, crc (type + data));
+
+	file << length << type << data << checksum;
+}
+
+void Png_Writer::update_adler (std::uint8_t const* data, size_t size)
+{
+	const std::uint32_t modulo = 65521;
+	for (size_t i = 0; i < size; ++i)
+	{
+		adler_a = (adler_a + data[i]) % modulo;
+		adler_b = (adler_b + adler_a) % modulo;
+	}
+}
+
+std::unique_ptr<Image_Writer> create_image_writer (
+	fs::path const&     path,
+	unsigned int        width,
+	unsigned int        height,
+	Writer_State const& resume)
+{
+	const std::string extension = path.extension().string();
+	if (extension == ".ppm")
+	{
+		return std::make_unique<Ppm_Writer> (path, width, height, resume);
+	}
+
+	if (extension == ".png")
+	{
+		return std::make_unique<Png_Writer> (path, width, height, resume);
+	}
+
+	return nullptr;
+}
+
+} // namespace io
+
+namespace renderer
+{
+
+bool write_image (fs::path const& path, Image const& image)
+{
+	std::unique_ptr<io::Image_Writer> writer
+		= io::create_image_writer (path, image.width, image.height);
+	if (writer == nullptr)
+	{
+		std::cerr << "Unsupported image format: " << path.string() << "\n";
+		return false;
+	}
+
+	writer->write_rows (image.pixels.data(), image.height);
+	writer->finish();
+	return writer->is_valid();
+}
+
+} // namespace renderer
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace io
+{
+
+// How much of an image has been written, enough to resume writing it.
+struct Writer_State
+{
+	unsigned int  rows     = 0;
+	std::uint64_t bytes    = 0;
+	std::uint32_t checksum = 1;
+};
+
+// Writes an 8 bit RGB image row by row, so that the whole image never needs
+//  to be held in memory.
+class Image_Writer
+{
+public:
+	virtual ~Image_Writer() = default;
+
+	bool is_valid() const;
+
+	// Flushes the rows written so far and describes them.
+	virtual Writer_State get_state();
+
+	// Rows are written from the top of the image, each one is width RGB
+	//  triplets.
+	virtual void write_rows (std::uint8_t const* rows, unsigned int count) = 0;
+	virtual void finish()                                               = 0;
+
+protected:
+	// Continues an image after the rows of the given state, the file is
+	//  truncated to drop anything written after it.
+	Image_Writer (
+		std::filesystem::path const& path,
+		unsigned int                 width,
+		unsigned int                 height,
+		Writer_State const&          resume);
+
+	std::ofstream file;
+	unsigned int  width;
+	unsigned int  height;
+	unsigned int  rows_written = 0;
+};
+
+class Ppm_Writer : public Image_Writer
+{
+public:
+	Ppm_Writer (
+		std::filesystem::path const& path,
+		unsigned int                 width,
+		unsigned int                 height,
+		Writer_State const&          resume = {});
+
+	void write_rows (std::uint8_t const* rows, unsigned int count) override;
+	void finish() override;
+};
+
+// Stores the image data in uncompressed deflate blocks, which keeps the
+//  writer free of dependencies and lets it stream rows straight to disk.
+class Png_Writer : public Image_Writer
+{
+public:
+	Png_Writer (
+		std::filesystem::path const& path,
+		unsigned int                 width,
+		unsigned int                 height,
+		Writer_State const&          resume = {});
+
+	void write_rows (std::uint8_t const* rows, unsigned int count) override;
+	void finish() override;
+
+	Writer_State get_state() override;
+
+private:
+	std::uint32_t adler_a = 1;
+	std::uint32_t adler_b = 0;
+
+	void write_chunk (std::string const& type, std::string const& data);
+	void update_adler (std::uint8_t const* data, size_t size);
+};
+
+// Picks the writer from the extension of the path, returns null for
+//  unsupported extensions.
+std::unique_ptr<Image_Writer> create_image_writer (
+	std::filesystem::path const& path,
+	unsigned int                 width,
+	unsigned int                 height,
+	Writer_State const&          resume = {});
+
+} // namespace io
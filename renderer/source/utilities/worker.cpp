@@ -0,0 +1,60 @@
+#include "worker.hpp"
+
+namespace renderer
+{
+
+Worker::Worker() : thread (&Worker::run, this) {}
+
+Worker::~Worker()
+{
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		stopping = true;
+	}
+	task_posted.notify_one();
+	thread.join();
+}
+
+void Worker::post (std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		tasks.push_back (std::move (task));
+	}
+	task_posted.notify_one();
+}
+
+void Worker::wait_idle()
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	tasks_finished.wait (lock, [this] { return tasks.empty() && !busy; });
+}
+
+void Worker::run()
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	while (true)
+	{
+		task_posted.wait (lock, [this] { return stopping || !tasks.empty(); });
+		if (tasks.empty())
+		{
+			return;
+		}
+
+		std::function<void()> task = std::move (tasks.front());
+		tasks.pop_front();
+		busy = true;
+
+		lock.unlock();
+		task();
+		lock.lock();
+
+		busy = false;
+		if (tasks.empty())
+		{
+			tasks_finished.notify_all();
+		}
+	}
+}
+
+} // namespace renderer
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace renderer
+{
+
+// Runs tasks in the order they were posted on a single background thread.
+class Worker
+{
+public:
+	Worker();
+
+	// Finishes the tasks already posted before returning.
+	~Worker();
+
+	Worker (Worker const&) = delete;
+	Worker& operator= (Worker const&) = delete;
+
+	void post (std::function<void()> task);
+
+	// Blocks until every posted task has finished.
+	void wait_idle();
+
+private:
+	std::mutex                        mutex;
+	std::condition_variable           task_posted;
+	std::condition_variable           tasks_finished;
+	std::deque<std::function<void()>> tasks;
+	bool                              busy     = false;
+	bool                              stopping = false;
+
+	std::thread thread;
+
+	void run();
+};
+
+} // namespace renderer
@@ -0,0 +1,316 @@
+#include "input_recording.hpp"
+
+#include "renderer.hpp"
+#include "singletons.hpp"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFileInfo>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <utility>
+
+namespace
+{
+const Qt::Key move_keys[] = {
+	Qt::Key_W,
+	Qt::Key_A,
+	Qt::Key_S,
+	Qt::Key_D,
+	Qt::Key_Space,
+	Qt::Key_Control};
+
+int pack_move_keys (QMap<Qt::Key, bool> const& pressed)
+{
+	int packed = 0;
+	for (size_t i = 0; i < std::size (move_keys); ++i)
+	{
+		if (pressed.value (move_keys[i]))
+		{
+			packed |= 1 << i;
+		}
+	}
+	return packed;
+}
+
+QMap<Qt::Key, bool> unpack_move_keys (int packed)
+{
+	QMap<Qt::Key, bool> pressed;
+	for (size_t i = 0; i < std::size (move_keys); ++i)
+	{
+		pressed[move_keys[i]] = (packed & (1 << i)) != 0;
+	}
+	return pressed;
+}
+
+float percentile (QVector<float> values, double fraction)
+{
+	if (values.isEmpty())
+	{
+		return 0.0f;
+	}
+
+	std::sort (values.begin(), values.end());
+	const int index = static_cast<int> (
+		std::ceil (fraction * values.size()) - 1.0);
+	return values[std::max (index, 0)];
+}
+} // namespace
+
+Input_Recorder::Input_Recorder (QString const& path) : m_file (path)
+{
+	if (!m_file.open (QIODevice::WriteOnly | QIODevice::Text))
+	{
+		qDebug() << "Could not open recording" << path;
+		return;
+	}
+	m_stream.setDevice (&m_file);
+	m_stream.setRealNumberPrecision (9);
+
+	connect (
+		&Singletons::renderer(),
+		&Renderer::update_shader,
+		this,
+		[this] { m_started = true; });
+}
+
+bool Input_Recorder::is_open() const
+{
+	return m_file.isOpen();
+}
+
+void Input_Recorder::record_input (Camera_Screen_Input const& input)
+{
+	if (!m_started)
+	{
+		return;
+	}
+
+	if (input.has_motion())
+	{
+		m_stream << "input " << m_tick << ' ' << input.width << ' '
+				 << input.height << ' '
+				 << pack_move_keys (input.move_keys_pressed) << ' '
+				 << input.pan_direction.x() << ' '
+				 << input.pan_direction.y() << ' ' << input.zoom_direction
+				 << '\n';
+	}
+	++m_tick;
+}
+
+void Input_Recorder::record_shader (QString const& name)
+{
+	if (m_started)
+	{
+		m_stream << "shader " << m_tick << ' ' << name << '\n';
+	}
+}
+
+void Input_Recorder::record_uniform (
+	QString const& name,
+	double         value,
+	quint32        index)
+{
+	if (m_started)
+	{
+		m_stream << "uniform " << m_tick << ' ' << name << ' ' << index << ' '
+				 << value << '\n';
+	}
+}
+
+Input_Replay::Input_Replay (QString const& path) : m_path (path)
+{
+	m_valid = load();
+	if (!m_valid)
+	{
+		return;
+	}
+
+	connect (
+		&Singletons::renderer(),
+		&Renderer::update_shader,
+		this,
+		[this] {
+			if (!m_started)
+			{
+				m_started = true;
+				Singletons::renderer().set_frame_log (true);
+			}
+		});
+}
+
+bool Input_Replay::is_valid() const
+{
+	return m_valid;
+}
+
+bool Input_Replay::load()
+{
+	QFile file (m_path);
+	if (!file.open (QIODevice::ReadOnly | QIODevice::Text))
+	{
+		qDebug() << "Could not open recording" << m_path;
+		return false;
+	}
+
+	QTextStream stream (&file);
+	int         line_number = 0;
+	while (!stream.atEnd())
+	{
+		++line_number;
+		const QStringList words
+			= stream.readLine().split (' ', Qt::SkipEmptyParts);
+		if (words.isEmpty())
+		{
+			continue;
+		}
+
+		Step step{};
+		bool valid = words.size() >= 3;
+		if (valid)
+		{
+			step.tick = words[1].toULongLong (&valid);
+		}
+
+		if (valid && words[0] == "shader" && words.size() == 3)
+		{
+			step.type = Type::Shader;
+			step.name = words[2];
+		}
+		else if (valid && words[0] == "uniform" && words.size() == 5)
+		{
+			step.type  = Type::Uniform;
+			step.name  = words[2];
+			step.index = words[3].toUInt();
+			step.value = words[4].toDouble();
+		}
+		else if (valid && words[0] == "input" && words.size() == 8)
+		{
+			step.type      = Type::Input;
+			step.width     = words[2].toFloat();
+			step.height    = words[3].toFloat();
+			step.move_keys = words[4].toInt();
+			step.pan       = QVector2D (words[5].toFloat(), words[6].toFloat());
+			step.zoom      = words[7].toFloat();
+		}
+		else
+		{
+			qDebug() << "Invalid step in recording" << m_path << "on line"
+					 << line_number;
+			return false;
+		}
+		m_steps.append (step);
+	}
+	return true;
+}
+
+Camera_Screen_Input Input_Replay::next_tick (float width, float height)
+{
+	Camera_Screen_Input idle ({}, QVector2D(), 0.0f, width, height);
+	if (!m_started || is_finished())
+	{
+		return idle;
+	}
+
+	Renderer& renderer = Singletons::renderer();
+	for (; m_next_step < m_steps.size(); ++m_next_step)
+	{
+		Step const& step = m_steps[m_next_step];
+		if (step.tick != m_tick)
+		{
+			break;
+		}
+
+		switch (step.type)
+		{
+		case Type::Shader:
+			renderer.set_shader (step.name);
+			break;
+
+		case Type::Uniform:
+		{
+			if (!renderer.exists_uniform (step.name))
+			{
+				qDebug() << "Recorded uniform" << step.name << "does not exist";
+				break;
+			}
+
+			Uniform uniform = renderer.get_uniform (step.name);
+			uniform.set_number (step.value, step.index);
+			renderer.set_uniform (uniform);
+			break;
+		}
+
+		case Type::Input:
+			++m_tick;
+			++m_next_step;
+			return Camera_Screen_Input (
+				unpack_move_keys (step.move_keys),
+				step.pan,
+				step.zoom,
+				step.width,
+				step.height);
+		}
+	}
+	++m_tick;
+	return idle;
+}
+
+bool Input_Replay::is_finished() const
+{
+	return m_next_step >= m_steps.size();
+}
+
+void Input_Replay::finish()
+{
+	if (std::exchange (m_finished, true))
+	{
+		return;
+	}
+
+	const QVector<Frame_Sample> frames
+		= Singletons::renderer().take_frame_log();
+	Singletons::renderer().set_frame_log (false);
+
+	const QFileInfo info (m_path);
+	const QString   timings_path
+		= info.path() + "/" + info.completeBaseName() + ".timings.csv";
+
+	QFile timings (timings_path);
+	if (timings.open (QIODevice::WriteOnly | QIODevice::Text))
+	{
+		QTextStream stream (&timings);
+		stream << "frame,cpu_ms,gpu_ms,uniform_uploads\n";
+		for (int i = 0; i < frames.size(); ++i)
+		{
+			stream << i << ',' << frames[i].cpu_ms << ',' << frames[i].gpu_ms
+				   << ',' << frames[i].uniform_uploads << '\n';
+		}
+	}
+	else
+	{
+		qDebug() << "Could not write frame timings to" << timings_path;
+	}
+
+	QVector<float> cpu;
+	QVector<float> gpu;
+	for (Frame_Sample const& frame : frames)
+	{
+		cpu.append (frame.cpu_ms);
+		gpu.append (frame.gpu_ms);
+	}
+
+	qInfo().noquote() << QString ("Replayed %1 ticks in %2 frames, "
+								  "cpu p50 %3 ms p99 %4 ms, "
+								  "gpu p50 %5 ms p99 %6 ms")
+							 .arg (m_tick)
+							 .arg (frames.size())
+							 .arg (percentile (cpu, 0.5), 0, 'f', 2)
+							 .arg (percentile (cpu, 0.99), 0, 'f', 2)
+							 .arg (percentile (gpu, 0.5), 0, 'f', 2)
+							 .arg (percentile (gpu, 0.99), 0, 'f', 2);
+
+	QCoreApplication::quit();
+}
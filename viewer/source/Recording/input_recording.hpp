@@ -0,0 +1,93 @@
+#pragma once
+
+#include "camera_controller.hpp"
+
+#include <QFile>
+#include <QObject>
+#include <QString>
+#include <QTextStream>
+#include <QVector>
+
+// A recording is a text file with one step per line, each step belongs to a
+//  tick which is one update of the viewport:
+//  shader <tick> <name>
+//  uniform <tick> <name> <index> <value>
+//  input <tick> <width> <height> <move keys> <pan x> <pan y> <zoom>
+//  Ticks without camera motion are left out. Ticks start counting once the
+//  first shader is loaded, so that a replay starts from the same state.
+
+// Writes the camera input of every tick and the shader and uniform changes
+//  made in the inspector.
+class Input_Recorder : public QObject
+{
+	Q_OBJECT
+
+public:
+	Input_Recorder (QString const& path);
+
+	bool is_open() const;
+
+	// Called once per tick.
+	void record_input (Camera_Screen_Input const& input);
+	void record_shader (QString const& name);
+	void record_uniform (QString const& name, double value, quint32 index);
+
+private:
+	QFile       m_file;
+	QTextStream m_stream;
+	quint64     m_tick    = 0;
+	bool        m_started = false;
+};
+
+// Plays a recording back one tick per viewport update, regardless of how long
+//  the frames take, and collects the frame timings of the replay.
+class Input_Replay : public QObject
+{
+	Q_OBJECT
+
+public:
+	Input_Replay (QString const& path);
+
+	bool is_valid() const;
+
+	// Applies the shader and uniform changes of the next tick and returns
+	//  its camera input, which is idle for ticks without motion.
+	Camera_Screen_Input next_tick (float width, float height);
+	bool                is_finished() const;
+
+	// Writes the frame timings as CSV next to the recording, prints a
+	//  summary and closes the application.
+	void finish();
+
+private:
+	enum class Type
+	{
+		Shader,
+		Uniform,
+		Input
+	};
+
+	struct Step
+	{
+		Type      type;
+		quint64   tick;
+		QString   name;
+		quint32   index;
+		double    value;
+		int       move_keys;
+		QVector2D pan;
+		float     zoom;
+		float     width;
+		float     height;
+	};
+
+	QString       m_path;
+	QVector<Step> m_steps;
+	int           m_next_step = 0;
+	quint64       m_tick      = 0;
+	bool          m_started   = false;
+	bool          m_valid     = false;
+	bool          m_finished  = false;
+
+	bool load();
+};
@@ -0,0 +1,12 @@
+import renderer.performance_overlay 1.0
+
+import QtQuick 2.2
+
+Performance_Overlay_
+{
+	id: performance_overlay
+
+	width: 300
+	height: 260
+	visible: false
+}
@@ -13,5 +13,17 @@ Viewport_
 		anchors.fill: parent
 	}
 
-	Component.onCompleted: viewport.set_screen_input(screen_input)
+	Performance_Overlay
+	{
+		id: performance_overlay
+		anchors.top: parent.top
+		anchors.left: parent.left
+		anchors.margins: 8
+	}
+
+	Component.onCompleted:
+	{
+		viewport.set_screen_input(screen_input)
+		viewport.set_performance_overlay(performance_overlay)
+	}
 }
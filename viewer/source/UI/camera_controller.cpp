@@ -3,6 +3,10 @@
 #include "constants.hpp"
 #include "singletons.hpp"
 
+#include <renderer/trace.hpp>
+
+#include <algorithm>
+
 namespace
 {
 
@@ -55,8 +59,18 @@ float Camera_Screen_Input::determine_move_direction (
 	return direction;
 }
 
+bool Camera_Screen_Input::has_motion() const
+{
+	const bool key_pressed = std::any_of (
+		move_keys_pressed.begin(),
+		move_keys_pressed.end(),
+		[] (bool pressed) { return pressed; });
+	return key_pressed || !pan_direction.isNull() || zoom_direction != 0.0f;
+}
+
 void Camera_Controller::update_uniforms (Camera_Screen_Input const& input)
 {
+	TRACE_SCOPE ("Camera_Controller::update_uniforms");
 	update_camera_dimensions();
 	if (dimensions == Dimensions::Zero)
 	{
@@ -161,12 +175,32 @@ void Camera_Controller::update_position_2d (
 		return;
 	}
 
-	QVector2D previous_position{
-		get_uniform_vector_value (pos_name, 0),
-		get_uniform_vector_value (pos_name, 1)};
+	move_position_2d (position_offset);
+}
+
+void Camera_Controller::move_position_2d (QVector2D const& offset)
+{
+	Uniform position = Singletons::renderer().get_uniform (pos_name);
+	if (!Singletons::renderer().exists_uniform (pos_low_name))
+	{
+		position.set_value (position.value (0).toFloat() + offset.x(), 0);
+		position.set_value (position.value (1).toFloat() + offset.y(), 1);
+		Singletons::renderer().set_uniform (position);
+		return;
+	}
 
-	QVector3D position = previous_position + position_offset;
-	set_uniform_vector_value (pos_name, {position.x(), position.y()});
+	Uniform position_low = Singletons::renderer().get_uniform (pos_low_name);
+	for (int index = 0; index < 2; ++index)
+	{
+		const double value = double{position.value (index).toFloat()}
+							 + double{position_low.value (index).toFloat()}
+							 + double{offset[index]};
+		const auto high = static_cast<float> (value);
+		position.set_value (high, index);
+		position_low.set_value (static_cast<float> (value - high), index);
+	}
+	Singletons::renderer().set_uniform (position);
+	Singletons::renderer().set_uniform (position_low);
 }
 
 void Camera_Controller::update_position_3d (
@@ -228,10 +262,7 @@ void Camera_Controller::update_view_2d (
 	QVector2D   view_offset = QVector2D (offset.x(), offset.y() * aspect)
 							/ cnst::screen_in_pixels_2d;
 
-	Uniform position = Singletons::renderer().get_uniform (pos_name);
-	position.set_value (position.value (0).toFloat() + view_offset.x(), 0);
-	position.set_value (position.value (1).toFloat() + view_offset.y(), 1);
-	Singletons::renderer().set_uniform (position);
+	move_position_2d (view_offset);
 }
 
 void Camera_Controller::update_view_3d (
@@ -33,6 +33,7 @@ public:
 	const float               height;
 
 	float determine_move_direction (Qt::Key forward, Qt::Key backwards) const;
+	bool  has_motion() const;
 };
 
 class Camera_Controller
@@ -41,10 +42,11 @@ public:
 	void update_uniforms (Camera_Screen_Input const& input);
 
 private:
-	const QString pos_name   = "camera.position";
-	const QString pitch_name = "camera.pitch";
-	const QString yaw_name   = "camera.yaw";
-	const QString zoom_name  = "camera.zoom";
+	const QString pos_name     = "camera.position";
+	const QString pos_low_name = "camera.position_low";
+	const QString pitch_name   = "camera.pitch";
+	const QString yaw_name     = "camera.yaw";
+	const QString zoom_name    = "camera.zoom";
 
 	const float scroll_wheels_to_max_zoom = 20;
 	const float scroll_speed              = 2.0f;
@@ -65,6 +67,10 @@ private:
 		float                      multiplier,
 		Camera_Screen_Input const& input);
 
+	// Moves the 2D camera, in double-float for shaders with the low part of
+	//  the position so that small steps far from the origin are not lost.
+	void move_position_2d (QVector2D const& offset);
+
 	void update_position_3d (
 		float                      multiplier,
 		Camera_Screen_Input const& input);
@@ -3,6 +3,8 @@
 #include "renderer.hpp"
 #include "singletons.hpp"
 
+#include <renderer/trace.hpp>
+
 #include <QList>
 #include <QtMath>
 
@@ -29,6 +31,7 @@ Inspector::Inspector()
 
 void Inspector::update_shader (int index)
 {
+	TRACE_SCOPE ("Inspector::update_shader");
 	if (index >= shader_names.size() || index < 0)
 	{
 		qDebug() << "Inspector shader selection index out of range";
@@ -36,6 +39,10 @@ void Inspector::update_shader (int index)
 	}
 
 	Singletons::renderer().set_shader (shader_names[index]);
+	if (Input_Recorder* recorder = Singletons::recorder())
+	{
+		recorder->record_shader (shader_names[index]);
+	}
 }
 
 QStringList Inspector::create_uniforms_qml_source()
@@ -55,30 +62,14 @@ void Inspector::set_uniform_value (
 	double         value,
 	quint32        index)
 {
+	TRACE_SCOPE ("Inspector::set_uniform_value");
 	Uniform uniform = Singletons::renderer().get_uniform (name);
-	switch (uniform.type())
+	uniform.set_number (value, index);
+	Singletons::renderer().set_uniform (uniform);
+	if (Input_Recorder* recorder = Singletons::recorder())
 	{
-	case Uniform::Type::Int:
-		uniform.set_value (static_cast<int> (value), index);
-		break;
-
-	case Uniform::Type::UInt:
-		uniform.set_value (static_cast<unsigned int> (value), index);
-		break;
-
-	case Uniform::Type::Float:
-		uniform.set_value (static_cast<float> (value), index);
-		break;
-
-	case Uniform::Type::Double:
-		uniform.set_value (static_cast<double> (value), index);
-		break;
-
-	case Uniform::Type::Invalid:
-		assert (false && "Uniform has Invalid as type.");
-		break;
+		recorder->record_uniform (name, value, index);
 	}
-	Singletons::renderer().set_uniform (uniform);
 }
 
 void Inspector::shader_list_updated()
@@ -0,0 +1,173 @@
+#include "performance_overlay.hpp"
+
+#include "constants.hpp"
+#include "singletons.hpp"
+
+#include <QFontDatabase>
+#include <QPainter>
+#include <QPainterPath>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr qreal  text_height = 16.0;
+constexpr qreal  padding     = 6.0;
+constexpr qint64 second_ms   = 1000;
+
+QPainterPath frame_time_path (
+	QVector<Frame_Sample> const& frames,
+	float Frame_Sample::*        time,
+	QRectF const&                area,
+	float                        max_ms)
+{
+	QPainterPath path;
+	const qreal  step = area.width() / (cnst::performance_history - 1);
+	for (int i = 0; i < frames.size(); ++i)
+	{
+		const qreal x = area.left() + step * i;
+		const qreal y = area.bottom()
+						- area.height()
+							  * std::min (frames[i].*time / max_ms, 1.0f);
+		if (i == 0)
+		{
+			path.moveTo (x, y);
+		}
+		else
+		{
+			path.lineTo (x, y);
+		}
+	}
+	return path;
+}
+} // namespace
+
+Performance_Overlay::Performance_Overlay (QQuickItem* parent)
+	: QQuickPaintedItem (parent)
+{
+	setOpaquePainting (false);
+	connect (
+		&m_refresh,
+		&QTimer::timeout,
+		this,
+		&Performance_Overlay::refresh);
+	m_refresh.start (cnst::performance_refresh_ms);
+}
+
+void Performance_Overlay::refresh()
+{
+	if (!isVisible())
+	{
+		return;
+	}
+
+	m_snapshot = Singletons::renderer().get_performance();
+	update();
+}
+
+void Performance_Overlay::paint (QPainter* painter)
+{
+	painter->fillRect (boundingRect(), QColor (0, 0, 0, 160));
+	painter->setFont (QFontDatabase::systemFont (QFontDatabase::FixedFont));
+	painter->setPen (Qt::white);
+
+	// Averages over the last second, the viewer only draws on demand so an
+	//  idle viewport shows no frames.
+	int   frames          = 0;
+	float cpu_ms          = 0.0f;
+	float gpu_ms          = 0.0f;
+	int   uniform_uploads = 0;
+	for (Frame_Sample const& frame : m_snapshot.frames)
+	{
+		if (m_snapshot.now_ms - frame.timestamp_ms <= second_ms)
+		{
+			++frames;
+			cpu_ms += frame.cpu_ms;
+			gpu_ms += frame.gpu_ms;
+			uniform_uploads += frame.uniform_uploads;
+		}
+	}
+	const float average = frames > 0 ? 1.0f / frames : 0.0f;
+
+	QStringList lines;
+	lines << QString ("FPS      %1").arg (frames);
+	lines << QString ("CPU      %1 ms").arg (cpu_ms * average, 0, 'f', 2);
+	lines << QString ("GPU      %1 ms").arg (gpu_ms * average, 0, 'f', 2);
+	lines << QString ("Uniforms %1 / frame")
+				 .arg (uniform_uploads * average, 0, 'f', 1);
+	if (!m_snapshot.latencies_ms.isEmpty())
+	{
+		QVector<float> latencies = m_snapshot.latencies_ms;
+		std::sort (latencies.begin(), latencies.end());
+		const auto percentile = [&latencies] (double fraction) {
+			const int index = static_cast<int> (
+				std::ceil (fraction * latencies.size()) - 1.0);
+			return latencies[std::max (index, 0)];
+		};
+		lines << QString ("Latency  p50 %1  p90 %2 ms")
+					 .arg (percentile (0.5), 0, 'f', 1)
+					 .arg (percentile (0.9), 0, 'f', 1);
+		lines << QString ("         p99 %1  max %2 ms")
+					 .arg (percentile (0.99), 0, 'f', 1)
+					 .arg (latencies.back(), 0, 'f', 1);
+	}
+	for (auto compile = m_snapshot.compile_times.cbegin();
+		 compile != m_snapshot.compile_times.cend();
+		 ++compile)
+	{
+		lines << QString ("Compile  %1 ms %2")
+					 .arg (compile.value(), 0, 'f', 1)
+					 .arg (compile.key());
+	}
+
+	qreal y = padding;
+	for (QString const& line : lines)
+	{
+		painter->drawText (
+			QRectF (padding, y, width() - 2.0 * padding, text_height),
+			Qt::AlignLeft | Qt::AlignVCenter,
+			line);
+		y += text_height;
+	}
+
+	const QRectF graph (
+		padding,
+		y + padding,
+		width() - 2.0 * padding,
+		height() - y - 2.0 * padding);
+	if (graph.height() > 0.0)
+	{
+		paint_graph (painter, graph);
+	}
+}
+
+void Performance_Overlay::paint_graph (
+	QPainter*     painter,
+	QRectF const& area) const
+{
+	// Twice the target frame time keeps the budget line in the middle, and
+	//  slower frames are clamped to the top.
+	const float max_ms = 2.0f * cnst::target_frame_time_ms;
+
+	painter->setPen (QColor (255, 255, 255, 80));
+	painter->drawRect (area);
+	const qreal budget = area.center().y();
+	painter->drawLine (
+		QPointF (area.left(), budget),
+		QPointF (area.right(), budget));
+
+	painter->setRenderHint (QPainter::Antialiasing);
+	painter->setPen (QColor (80, 200, 255));
+	painter->drawPath (frame_time_path (
+		m_snapshot.frames,
+		&Frame_Sample::cpu_ms,
+		area,
+		max_ms));
+	painter->setPen (QColor (255, 160, 40));
+	painter->drawPath (frame_time_path (
+		m_snapshot.frames,
+		&Frame_Sample::gpu_ms,
+		area,
+		max_ms));
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "renderer.hpp"
+
+#include <QTimer>
+#include <QtQuick/QQuickPaintedItem>
+
+// Frame rate, frame times and a frame time graph drawn over the viewport.
+//  The timings are copied from the renderer a few times per second, so
+//  painting never waits for the render thread.
+class Performance_Overlay : public QQuickPaintedItem
+{
+	Q_OBJECT
+
+public:
+	Performance_Overlay (QQuickItem* parent = nullptr);
+
+	void paint (QPainter* painter) override;
+
+private:
+	QTimer               m_refresh;
+	Performance_Snapshot m_snapshot;
+
+	void refresh();
+	void paint_graph (QPainter* painter, QRectF const& area) const;
+};
@@ -1,5 +1,9 @@
 #include "screen_input.hpp"
 
+#include <renderer/trace.hpp>
+
+#include <utility>
+
 Screen_Input::Screen_Input (QQuickItem* parent) : QQuickItem (parent)
 {
 	reset_move_direction();
@@ -33,8 +37,20 @@ void Screen_Input::reset_input()
 	m_zoom_direction = 0.0f;
 }
 
+bool Screen_Input::take_action (Qt::Key key)
+{
+	return m_actions.remove (key);
+}
+
+std::optional<std::chrono::steady_clock::time_point>
+Screen_Input::take_input_time()
+{
+	return std::exchange (m_input_time, std::nullopt);
+}
+
 bool Screen_Input::eventFilter (QObject* watched, QEvent* event)
 {
+	TRACE_SCOPE ("Screen_Input::eventFilter");
 	switch (event->type())
 	{
 	case QEvent::HoverEnter:
@@ -49,6 +65,16 @@ bool Screen_Input::eventFilter (QObject* watched, QEvent* event)
 	case QEvent::KeyPress:
 	case QEvent::KeyRelease:
 	{
+		QKeyEvent const& key_event = *static_cast<QKeyEvent*> (event);
+		const Qt::Key    key       = static_cast<Qt::Key> (key_event.key());
+		if (key == Qt::Key_F2 || key == Qt::Key_F3 || key == Qt::Key_F12)
+		{
+			if (event->type() == QEvent::KeyPress)
+			{
+				m_actions.insert (key);
+			}
+			break;
+		}
 		update_move_direction (*static_cast<QKeyEvent*> (event));
 		break;
 	}
@@ -70,6 +96,10 @@ bool Screen_Input::eventFilter (QObject* watched, QEvent* event)
 	default: return QObject::eventFilter (watched, event);
 	}
 
+	if (!m_input_time)
+	{
+		m_input_time = std::chrono::steady_clock::now();
+	}
 	emit input_updated();
 	return true;
 }
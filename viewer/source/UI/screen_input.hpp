@@ -3,10 +3,14 @@
 #include <QKeyEvent>
 #include <QMap>
 #include <QMouseEvent>
+#include <QSet>
 #include <QQuickItem>
 #include <QVector2D>
 #include <QWheelEvent>
 
+#include <chrono>
+#include <optional>
+
 class Screen_Input : public QQuickItem
 {
 	Q_OBJECT
@@ -21,6 +25,15 @@ public:
 	float               zoom_direction() const;
 	void                reset_input();
 
+	// Returns whether the action key was pressed since the last call, action
+	//  keys are F2 for the performance overlay, F3 for the cost overlay and
+	//  F12 for a screenshot.
+	bool take_action (Qt::Key key);
+
+	// Time of the oldest input event since the last call, the start of the
+	//  input to frame latency.
+	std::optional<std::chrono::steady_clock::time_point> take_input_time();
+
 signals:
 	void input_updated();
 
@@ -32,6 +45,9 @@ private:
 	QVector2D           m_last_mouse_position;
 	QVector2D           m_pan_direction;
 	float               m_zoom_direction = 0.0f;
+	QSet<Qt::Key>       m_actions;
+
+	std::optional<std::chrono::steady_clock::time_point> m_input_time;
 
 	void reset_move_direction();
 	void update_move_direction (QKeyEvent const& key_event);
@@ -3,6 +3,8 @@
 #include "renderer.hpp"
 #include "singletons.hpp"
 
+#include <renderer/trace.hpp>
+
 #include <QString>
 #include <QStringList>
 
@@ -36,20 +38,85 @@ void Viewport::set_screen_input(QObject* qobject)
 		&Viewport::render);
 }
 
+void Viewport::set_performance_overlay (QQuickItem* overlay)
+{
+	performance_overlay = overlay;
+}
+
 void Viewport::render()
 {
-	Camera_Screen_Input input = camera_screen_input();
+	TRACE_SCOPE ("Viewport::render");
+	Camera_Screen_Input input      = camera_screen_input();
+	const auto          input_time = screen_input->take_input_time();
 	screen_input->reset_input();
 	camera.update_uniforms (input);
 
+	if (Input_Recorder* recorder = Singletons::recorder())
+	{
+		recorder->record_input (input);
+	}
+
+	if (input_time)
+	{
+		Singletons::renderer().stamp_input (*input_time);
+	}
+
+	if (input.has_motion())
+	{
+		Singletons::renderer().notify_interaction();
+	}
+
+	if (screen_input->take_action (Qt::Key_F2) && performance_overlay)
+	{
+		performance_overlay->setVisible (!performance_overlay->isVisible());
+	}
+
+	if (screen_input->take_action (Qt::Key_F3))
+	{
+		Singletons::renderer().toggle_cost_overlay();
+		update();
+	}
+
+	if (screen_input->take_action (Qt::Key_F12))
+	{
+		Singletons::renderer().request_screenshot();
+		update();
+	}
+
 	if (Singletons::renderer().do_shader_settings_need_updating())
 	{
 		update();
 	}
+
+	if (Input_Replay* replay = Singletons::replay())
+	{
+		continue_replay (*replay);
+	}
+}
+
+void Viewport::continue_replay (Input_Replay& replay)
+{
+	Renderer& renderer = Singletons::renderer();
+	if (replay.is_finished() && !renderer.do_shader_settings_need_updating()
+		&& renderer.is_frame_complete())
+	{
+		replay.finish();
+		return;
+	}
+
+	// Every update is a tick of the replay.
+	update();
 }
 
 Camera_Screen_Input Viewport::camera_screen_input()
 {
+	if (Input_Replay* replay = Singletons::replay())
+	{
+		return replay->next_tick (
+			static_cast<float> (width()),
+			static_cast<float> (height()));
+	}
+
 	Camera_Screen_Input input = Camera_Screen_Input (
 		screen_input->move_keys(),
 		screen_input->pan_direction(),
@@ -77,15 +144,23 @@ Viewport_Renderer::createFramebufferObject (QSize const& size)
 
 void Viewport_Renderer::synchronize (QQuickFramebufferObject* quick_fbo)
 {
+	TRACE_SCOPE ("Viewport_Renderer::synchronize");
 	Singletons::renderer().update_shader_settings();
 }
 
 void Viewport_Renderer::render()
 {
+	TRACE_SCOPE ("Viewport_Renderer::render");
 	QPoint resolution{
 		static_cast<int>(framebufferObject()->width()),
 		static_cast<int>(framebufferObject()->height())};
 
-	Singletons::renderer().render (resolution);
+	const bool frame_complete = Singletons::renderer().render (resolution);
 	window->resetOpenGLState();
+
+	// Present the tiles drawn so far and continue with the rest next frame.
+	if (!frame_complete)
+	{
+		update();
+	}
 }
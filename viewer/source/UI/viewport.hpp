@@ -1,6 +1,7 @@
 #pragma once
 
 #include "camera_controller.hpp"
+#include "input_recording.hpp"
 #include "screen_input.hpp"
 
 #include <QOpenGLFramebufferObjectFormat>
@@ -20,12 +21,15 @@ public:
 	QQuickFramebufferObject::Renderer* createRenderer() const override;
 
 	Q_INVOKABLE void set_screen_input (QObject* qobject);
+	Q_INVOKABLE void set_performance_overlay (QQuickItem* overlay);
 
 private:
-	Screen_Input*     screen_input = nullptr;
+	Screen_Input*     screen_input        = nullptr;
+	QQuickItem*       performance_overlay = nullptr;
 	Camera_Controller camera;
 
 	void                render();
+	void                continue_replay (Input_Replay& replay);
 	Camera_Screen_Input camera_screen_input();
 };
 
@@ -1,11 +1,17 @@
 #include "renderer.hpp"
 
+#include "constants.hpp"
+
 #include <renderer/renderer.hpp>
+#include <renderer/trace.hpp>
 
 #include <QCoreApplication>
+#include <QDateTime>
 #include <QDebug>
 #include <QMutexLocker>
 
+#include <utility>
+
 namespace fs = std::filesystem;
 
 namespace
@@ -36,12 +42,24 @@ fs::path find_glsl_path()
 }
 } // namespace
 
-Renderer::Renderer() : glsl(find_glsl_path()) {}
+Renderer::Renderer() : glsl(find_glsl_path())
+{
+	m_clock.start();
+	m_frames.reserve (cnst::performance_history);
+	m_latencies.reserve (cnst::performance_history);
+}
 
 void Renderer::initialise()
 {
+	TRACE_SCOPE ("Renderer::initialise");
 	QMutexLocker lock (&m_mutex);
 	m_renderer_wrapper = std::make_unique<renderer::Renderer>();
+	m_renderer_wrapper->set_frame_budget (cnst::frame_budget_ms);
+	m_renderer_wrapper->set_target_frame_time (cnst::target_frame_time_ms);
+	m_renderer_wrapper->set_minimum_render_scale (cnst::minimum_render_scale);
+	m_renderer_wrapper->set_minimum_budget (cnst::minimum_budget);
+	m_renderer_wrapper->set_budget_uniforms (cnst::budget_uniforms);
+	m_renderer_wrapper->set_tile_cache_budget (cnst::tile_cache_megabytes);
 	init_shaders();
 }
 
@@ -108,6 +126,65 @@ void Renderer::set_uniform (Uniform const& uniform)
 	emit update_uniform (uniform.name());
 }
 
+void Renderer::notify_interaction()
+{
+	m_interaction = true;
+}
+
+void Renderer::stamp_input (std::chrono::steady_clock::time_point time)
+{
+	QMutexLocker lock (&m_mutex);
+
+	// Input which changed nothing never shows up in a frame.
+	if (!m_uniforms_to_update.empty() && !m_input_time)
+	{
+		m_input_time = time;
+	}
+}
+
+void Renderer::request_screenshot()
+{
+	m_screenshot = true;
+}
+
+void Renderer::toggle_cost_overlay()
+{
+	m_toggle_cost_overlay = true;
+}
+
+Performance_Snapshot Renderer::get_performance() const
+{
+	Performance_Snapshot snapshot;
+	QMutexLocker         lock (&m_performance_mutex);
+	snapshot.frames.reserve (m_frames.size());
+	for (int i = 0; i < m_frames.size(); ++i)
+	{
+		snapshot.frames.append (
+			m_frames[(m_next_frame + i) % m_frames.size()]);
+	}
+	snapshot.latencies_ms  = m_latencies;
+	snapshot.compile_times = m_compile_times;
+	snapshot.now_ms        = m_clock.elapsed();
+	return snapshot;
+}
+
+void Renderer::set_frame_log (bool enabled)
+{
+	QMutexLocker lock (&m_performance_mutex);
+	m_frame_log_enabled = enabled;
+}
+
+QVector<Frame_Sample> Renderer::take_frame_log()
+{
+	QMutexLocker lock (&m_performance_mutex);
+	return std::exchange (m_frame_log, {});
+}
+
+bool Renderer::is_frame_complete() const
+{
+	return m_frame_complete;
+}
+
 bool Renderer::do_shader_settings_need_updating()
 {
 	bool new_shader = !shader_name_to_set.isEmpty();
@@ -117,19 +194,129 @@ bool Renderer::do_shader_settings_need_updating()
 
 void Renderer::update_shader_settings()
 {
+	TRACE_SCOPE ("Renderer::update_shader_settings");
 	QMutexLocker lock (&m_mutex);
+	if (do_shader_settings_need_updating())
+	{
+		m_frame_complete = false;
+	}
 	set_new_shader();
 	update_uniforms();
+
+	if (m_interaction.exchange (false))
+	{
+		m_renderer_wrapper->notify_interaction();
+	}
+
+	if (m_toggle_cost_overlay.exchange (false))
+	{
+		m_cost_overlay = !m_cost_overlay;
+		m_renderer_wrapper->set_cost_overlay (m_cost_overlay);
+	}
 }
 
-void Renderer::render (QPoint const& resolution)
+bool Renderer::render (QPoint const& resolution)
 {
-	QMutexLocker lock (&m_mutex);
-	m_renderer_wrapper->render (resolution.x(), resolution.y());
+	TRACE_SCOPE ("Renderer::render");
+	QMutexLocker  lock (&m_mutex);
+	QElapsedTimer cpu_time;
+	cpu_time.start();
+	const bool frame_complete
+		= m_renderer_wrapper->render (resolution.x(), resolution.y());
+	record_frame (static_cast<float> (cpu_time.nsecsElapsed()) / 1.0e6f);
+
+	if (m_frame_input_time)
+	{
+		m_renderer_wrapper->notify_when_complete (
+			[this, input_time = *m_frame_input_time] (auto const completed) {
+				record_latency (completed - input_time);
+			});
+		m_frame_input_time.reset();
+	}
+
+	// Only whole frames are saved, a tiled or upscaled frame keeps the
+	//  request until it has finished.
+	if (frame_complete && m_screenshot.exchange (false))
+	{
+		capture_screenshot (resolution);
+	}
+
+	// Keep frames coming until the read back reached the encoder and the
+	//  GPU is known to have finished the frames showing input.
+	m_frame_complete = frame_complete
+					   && !m_renderer_wrapper->has_pending_captures()
+					   && !m_renderer_wrapper->has_pending_notifications();
+	return m_frame_complete;
+}
+
+void Renderer::capture_screenshot (QPoint const& resolution)
+{
+	const QString file_name
+		= cnst::screenshot_prefix
+		  + QDateTime::currentDateTime().toString ("yyyy-MM-dd_hh-mm-ss")
+		  + ".png";
+
+	m_renderer_wrapper->capture_frame (
+		resolution.x(),
+		resolution.y(),
+		[path = file_name.toStdString()] (renderer::Image image) {
+			if (renderer::write_image (path, image))
+			{
+				qDebug() << "Saved screenshot" << path.c_str();
+			}
+			else
+			{
+				qDebug() << "Could not save screenshot" << path.c_str();
+			}
+		});
+}
+
+void Renderer::record_frame (float cpu_ms)
+{
+	Frame_Sample sample;
+	sample.timestamp_ms    = m_clock.elapsed();
+	sample.cpu_ms          = cpu_ms;
+	sample.gpu_ms          = m_renderer_wrapper->get_last_gpu_frame_time();
+	sample.uniform_uploads = m_uniform_uploads;
+	m_uniform_uploads      = 0;
+
+	QMutexLocker lock (&m_performance_mutex);
+	if (m_frame_log_enabled)
+	{
+		m_frame_log.append (sample);
+	}
+
+	if (m_frames.size() < cnst::performance_history)
+	{
+		m_frames.append (sample);
+	}
+	else
+	{
+		m_frames[m_next_frame] = sample;
+	}
+	m_next_frame = (m_next_frame + 1) % cnst::performance_history;
+}
+
+void Renderer::record_latency (std::chrono::steady_clock::duration latency)
+{
+	const float latency_ms
+		= std::chrono::duration<float, std::milli> (latency).count();
+
+	QMutexLocker lock (&m_performance_mutex);
+	if (m_latencies.size() < cnst::performance_history)
+	{
+		m_latencies.append (latency_ms);
+	}
+	else
+	{
+		m_latencies[m_next_latency] = latency_ms;
+	}
+	m_next_latency = (m_next_latency + 1) % cnst::performance_history;
 }
 
 void Renderer::set_new_shader()
 {
+	TRACE_SCOPE ("Renderer::set_new_shader");
 	if (shader_name_to_set.isEmpty())
 	{
 		return;
@@ -147,16 +334,32 @@ void Renderer::set_new_shader()
 		m_uniforms[qt_uniform.name()] = qt_uniform;
 		m_uniforms_to_update.insert (qt_uniform.name());
 	}
+
+	{
+		QMutexLocker lock (&m_performance_mutex);
+		for (auto const& [name, statistics] :
+			 m_renderer_wrapper->get_gpu_statistics())
+		{
+			m_compile_times[QString::fromStdString (name)]
+				= statistics.compile;
+		}
+	}
 	emit update_shader();
 }
 
 void Renderer::update_uniforms()
 {
+	TRACE_SCOPE ("Renderer::update_uniforms");
 	for (QString const& uniform_name : m_uniforms_to_update)
 	{
 		Uniform&                           uniform = m_uniforms[uniform_name];
 		std::unique_ptr<renderer::Uniform> renderer_uniform{uniform};
 		m_renderer_wrapper->set_uniform (*renderer_uniform);
 	}
+	m_uniform_uploads += m_uniforms_to_update.size();
+	if (m_input_time)
+	{
+		m_frame_input_time = std::exchange (m_input_time, std::nullopt);
+	}
 	m_uniforms_to_update.clear();
 }
@@ -4,12 +4,34 @@
 
 #include <renderer/renderer.hpp>
 
+#include <QElapsedTimer>
 #include <QList>
 #include <QMap>
 #include <QMutex>
 #include <QSet>
+#include <QVector>
 
+#include <atomic>
+#include <chrono>
 #include <filesystem>
+#include <optional>
+
+// Timings of one frame drawn on the render thread.
+struct Frame_Sample
+{
+	qint64 timestamp_ms    = 0;
+	float  cpu_ms          = 0.0f;
+	float  gpu_ms          = 0.0f;
+	int    uniform_uploads = 0;
+};
+
+struct Performance_Snapshot
+{
+	QVector<Frame_Sample> frames; // Oldest first.
+	QVector<float>        latencies_ms;
+	QMap<QString, float>  compile_times;
+	qint64                now_ms = 0;
+};
 
 class Renderer : public QObject
 {
@@ -27,9 +49,36 @@ public:
 	Uniform        get_uniform (QString const& name);
 	void           set_uniform (Uniform const& uniform);
 
+	// Called from the GUI thread, applied on the next synchronisation.
+	void notify_interaction();
+
+	// Input which changed uniforms since the last synchronisation was made
+	//  at this time. Once the GPU finished the first frame showing it the
+	//  latency is added to the performance snapshot.
+	void stamp_input (std::chrono::steady_clock::time_point time);
+
+	// Saves the next complete frame to the working directory.
+	void request_screenshot();
+
+	// Shows the per pixel cost of the shader as a heatmap over the frame.
+	void toggle_cost_overlay();
+
+	// Copy of the recent frame timings, only waits for the render thread to
+	//  finish recording a frame and never for the frame itself.
+	Performance_Snapshot get_performance() const;
+
+	// While enabled every frame is also kept in a log without a size limit,
+	//  taking the log empties it.
+	void                  set_frame_log (bool enabled);
+	QVector<Frame_Sample> take_frame_log();
+
+	// Whether the last render finished its frame, so nothing more is drawn
+	//  until something changes.
+	bool is_frame_complete() const;
+
 	bool do_shader_settings_need_updating();
 	void update_shader_settings();
-	void render (QPoint const& resolution);
+	bool render (QPoint const& resolution);
 
 signals:
 	void update_shader_list();
@@ -47,9 +96,31 @@ private:
 	QMap<QString, std::filesystem::path> m_shaders;
 	QMap<QString, Uniform>               m_uniforms;
 	QSet<QString>                        m_uniforms_to_update;
+	std::atomic<bool>                    m_interaction{false};
+	std::atomic<bool>                    m_screenshot{false};
+	std::atomic<bool>                    m_toggle_cost_overlay{false};
+	std::atomic<bool>                    m_frame_complete{false};
+	bool                                 m_cost_overlay = false;
 
 	std::unique_ptr<renderer::Renderer> m_renderer_wrapper = nullptr;
 
+	mutable QMutex        m_performance_mutex;
+	QElapsedTimer         m_clock;
+	QVector<Frame_Sample> m_frames;
+	int                   m_next_frame        = 0;
+	bool                  m_frame_log_enabled = false;
+	QVector<Frame_Sample> m_frame_log;
+	int                   m_uniform_uploads = 0;
+	QMap<QString, float>  m_compile_times;
+	QVector<float>        m_latencies;
+	int                   m_next_latency = 0;
+
+	std::optional<std::chrono::steady_clock::time_point> m_input_time;
+	std::optional<std::chrono::steady_clock::time_point> m_frame_input_time;
+
 	void set_new_shader();
 	void update_uniforms();
+	void record_frame (float cpu_ms);
+	void record_latency (std::chrono::steady_clock::duration latency);
+	void capture_screenshot (QPoint const& resolution);
 };
\ No newline at end of file
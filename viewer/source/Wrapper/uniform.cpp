@@ -155,6 +155,32 @@ void Uniform::set_value (double value, unsigned int index)
 	m_values[index] = value;
 }
 
+void Uniform::set_number (double value, unsigned int index)
+{
+	switch (type())
+	{
+	case Type::Int:
+		set_value (static_cast<int> (value), index);
+		break;
+
+	case Type::UInt:
+		set_value (static_cast<unsigned int> (value), index);
+		break;
+
+	case Type::Float:
+		set_value (static_cast<float> (value), index);
+		break;
+
+	case Type::Double:
+		set_value (value, index);
+		break;
+
+	case Type::Invalid:
+		assert (false && "Uniform has Invalid as type.");
+		break;
+	}
+}
+
 bool Uniform::is_type_compatabile (QVariant const& value)
 {
 	const bool compatabile
@@ -38,6 +38,9 @@ public:
 	void     set_value (float value, unsigned int index);
 	void     set_value (double value, unsigned int index);
 
+	// Converts a number from the user interface to the type of the uniform.
+	void set_number (double value, unsigned int index);
+
 private:
 	QString         m_name;
 	Type            m_type = Type::Invalid;
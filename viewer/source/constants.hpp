@@ -1,5 +1,8 @@
 #include <QtMath>
 
+#include <string>
+#include <vector>
+
 namespace cnst
 {
 const float pi   = qAcos (-1);
@@ -10,4 +13,23 @@ const float     min_ui_float = std::pow (10.0f, -max_ui_float_decimal_points);
 
 constexpr float screen_in_pixels_2d = 512.0f;
 constexpr float zoom_factor         = 5.0f;
+
+constexpr float frame_budget_ms      = 12.0f;
+constexpr float target_frame_time_ms = 16.0f;
+constexpr float minimum_render_scale = 0.25f;
+constexpr float minimum_budget       = 0.25f;
+
+constexpr unsigned int tile_cache_megabytes = 256;
+
+// Uniforms capping the work per pixel, lowered while the camera moves.
+const std::vector<std::string> budget_uniforms
+	= {"ray_marcher.max_steps",
+	   "ray_marcher.max_ray_hits",
+	   "mandelbroth.iterations",
+	   "julia_set.iterations"};
+
+constexpr char screenshot_prefix[] = "screenshot_";
+
+constexpr int performance_history    = 240;
+constexpr int performance_refresh_ms = 250;
 } // namespace cnst
\ No newline at end of file
@@ -1,10 +1,14 @@
 #include "screen_input.hpp"
 #include "inspector.hpp"
 #include "main_window.hpp"
+#include "performance_overlay.hpp"
 #include "uniform.hpp"
 #include "viewport.hpp"
 #include "singletons.hpp"
 
+#include <renderer/trace.hpp>
+
+#include <QCommandLineParser>
 #include <QGuiApplication>
 #include <QOpenGLContextGroup>
 #include <QQmlApplicationEngine>
@@ -16,17 +20,65 @@ int main (int argc, char** argv)
 {
 	QGuiApplication application (argc, argv);
 
+	QCommandLineParser command_line;
+	command_line.addHelpOption();
+	const QCommandLineOption trace_option (
+		"trace",
+		"Write a Chrome trace of the session to <file>.",
+		"file");
+	const QCommandLineOption record_option (
+		"record",
+		"Record the input, shader and uniform changes to <file>.",
+		"file");
+	const QCommandLineOption replay_option (
+		"replay",
+		"Replay a recording, write its frame timings next to it and quit.",
+		"file");
+	command_line.addOption (trace_option);
+	command_line.addOption (record_option);
+	command_line.addOption (replay_option);
+	command_line.process (application);
+
+	if (command_line.isSet (trace_option))
+	{
+		renderer::trace::start (
+			command_line.value (trace_option).toStdString());
+	}
+
 	// QML Types
 	qmlRegisterType<Main_Window> ("renderer.main_window", 1, 0, "Main_Window_");
 	qmlRegisterType<Viewport> ("renderer.viewport", 1, 0, "Viewport_");
 	qmlRegisterType<Inspector> ("renderer.inspector", 1, 0, "Inspector_");
 	qmlRegisterType<Screen_Input> ("renderer.screen_input", 1, 0, "Screen_Input_");
+	qmlRegisterType<Performance_Overlay> (
+		"renderer.performance_overlay",
+		1,
+		0,
+		"Performance_Overlay_");
 
 	// QTypes
 	qRegisterMetaType<Uniform> ("Uniform");
 
 	Singletons::create_renderer();
 
+	if (command_line.isSet (replay_option))
+	{
+		if (!Singletons::create_replay (command_line.value (replay_option)))
+		{
+			return 1;
+		}
+	}
+	else if (command_line.isSet (record_option))
+	{
+		const QString recording = command_line.value (record_option);
+		if (!Singletons::create_recorder (recording))
+		{
+			return 1;
+		}
+	}
+
 	QQmlApplicationEngine engine (QUrl ("qrc:/UI/main.qml"));
-	return application.exec();
+	const int             result = application.exec();
+	renderer::trace::stop();
+	return result;
 }
\ No newline at end of file
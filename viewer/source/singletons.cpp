@@ -1,6 +1,8 @@
 #include "singletons.hpp"
 
-std::unique_ptr<Renderer> renderer_wrapper = nullptr;
+std::unique_ptr<Renderer>       renderer_wrapper = nullptr;
+std::unique_ptr<Input_Recorder> input_recorder   = nullptr;
+std::unique_ptr<Input_Replay>   input_replay     = nullptr;
 
 void Singletons::create_renderer()
 {
@@ -10,4 +12,34 @@ void Singletons::create_renderer()
 Renderer& Singletons::renderer()
 {
 	return *renderer_wrapper;
+}
+
+bool Singletons::create_recorder (QString const& path)
+{
+	input_recorder = std::make_unique<Input_Recorder> (path);
+	if (!input_recorder->is_open())
+	{
+		input_recorder = nullptr;
+	}
+	return input_recorder != nullptr;
+}
+
+bool Singletons::create_replay (QString const& path)
+{
+	input_replay = std::make_unique<Input_Replay> (path);
+	if (!input_replay->is_valid())
+	{
+		input_replay = nullptr;
+	}
+	return input_replay != nullptr;
+}
+
+Input_Recorder* Singletons::recorder()
+{
+	return input_recorder.get();
+}
+
+Input_Replay* Singletons::replay()
+{
+	return input_replay.get();
 }
\ No newline at end of file
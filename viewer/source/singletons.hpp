@@ -1,5 +1,6 @@
 #pragma once
 
+#include "input_recording.hpp"
 #include "renderer.hpp"
 
 namespace Singletons
@@ -8,4 +9,11 @@ namespace Singletons
 void      create_renderer();
 Renderer& renderer();
 
+// Only one of recording or replaying input can be active, both return null
+//  when inactive.
+bool            create_recorder (QString const& path);
+bool            create_replay (QString const& path);
+Input_Recorder* recorder();
+Input_Replay*   replay();
+
 };
\ No newline at end of file